@@ -0,0 +1,361 @@
+#include "audio.h"
+#include "spsc_queue.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <thread>
+
+#ifdef _WIN32
+#include <windows.h>
+#include <mmsystem.h>
+#ifdef _MSC_VER
+#pragma comment(lib, "winmm.lib")
+#endif
+#endif
+
+// Far more than anyone can click between two blocks
+const int COMMAND_QUEUE_SIZE = 64;
+
+struct PlayCommand {
+    int sound;
+    float gain;
+    long long queuedNs;  // steady_clock, for the latency figures
+};
+
+struct Voice {
+    int sound = -1;  // -1 when free
+    int frame = 0;
+    float gain = 1.0f;
+};
+
+struct AudioCounters {
+    std::atomic<long long> blocks{0};
+    std::atomic<long long> voicesStarted{0};
+    std::atomic<long long> voicesStolen{0};
+    std::atomic<long long> commandsDropped{0};
+    std::atomic<long long> lateBlocks{0};
+    std::atomic<long long> latencyTotalNs{0};
+    std::atomic<long long> latencyMaxNs{0};
+};
+
+static AudioConfig config;
+static const Sound* bank = nullptr;
+static int bankSize = 0;
+
+static SpscQueue<PlayCommand, COMMAND_QUEUE_SIZE> commands;
+static AudioCounters counters;
+static std::atomic<bool> running{false};
+static std::thread mixer;
+
+// Mixer thread only
+static Voice voices[MAX_VOICES];
+static FILE* wavFile = nullptr;
+static long long wavFrames = 0;
+
+static long long nowNs() {
+    using namespace std::chrono;
+    return duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count();
+}
+
+static bool startVoice(const PlayCommand& command) {
+    if (command.sound < 0 || command.sound >= bankSize) {
+        return false;
+    }
+    // A free voice, or else the one furthest through its sound
+    int slot = 0;
+    for (int i = 0; i < MAX_VOICES; ++i) {
+        if (voices[i].sound < 0) {
+            slot = i;
+            break;
+        }
+        if (voices[i].frame > voices[slot].frame) {
+            slot = i;
+        }
+    }
+    if (voices[slot].sound >= 0) {
+        counters.voicesStolen.fetch_add(1, std::memory_order_relaxed);
+    }
+    voices[slot].sound = command.sound;
+    voices[slot].frame = 0;
+    voices[slot].gain = command.gain;
+    counters.voicesStarted.fetch_add(1, std::memory_order_relaxed);
+    return true;
+}
+
+static void mixBlock(float* mix, short* out, int frames) {
+    std::fill(mix, mix + 2 * frames, 0.0f);
+    for (Voice& voice : voices) {
+        if (voice.sound < 0) {
+            continue;
+        }
+        const Sound& sound = bank[voice.sound];
+        int count = std::min(frames, soundFrames(sound) - voice.frame);
+        const float* source = &sound.samples[2 * static_cast<size_t>(voice.frame)];
+        for (int i = 0; i < 2 * count; ++i) {
+            mix[i] += source[i] * voice.gain;
+        }
+        voice.frame += count;
+        if (voice.frame >= soundFrames(sound)) {
+            voice.sound = -1;
+        }
+    }
+    for (int i = 0; i < 2 * frames; ++i) {
+        float value = std::max(-1.0f, std::min(1.0f, mix[i]));
+        out[i] = static_cast<short>(value * 32767.0f);
+    }
+}
+
+static void writeLE(FILE* file, unsigned int value, int count) {
+    for (int i = 0; i < count; ++i) {
+        fputc((value >> (8 * i)) & 0xFF, file);
+    }
+}
+
+// Sizes are patched in by finishWav() once the length is known
+static void writeWavHeader(FILE* file, int rate, long long frames) {
+    unsigned int dataSize = static_cast<unsigned int>(frames * 4);
+    fwrite("RIFF", 1, 4, file);
+    writeLE(file, 36 + dataSize, 4);
+    fwrite("WAVEfmt ", 1, 8, file);
+    writeLE(file, 16, 4);
+    writeLE(file, 1, 2);  // PCM
+    writeLE(file, 2, 2);  // Stereo
+    writeLE(file, rate, 4);
+    writeLE(file, rate * 4, 4);
+    writeLE(file, 4, 2);
+    writeLE(file, 16, 2);
+    fwrite("data", 1, 4, file);
+    writeLE(file, dataSize, 4);
+}
+
+static void finishWav() {
+    if (!wavFile) {
+        return;
+    }
+    fseek(wavFile, 0, SEEK_SET);
+    writeWavHeader(wavFile, config.rate, wavFrames);
+    fclose(wavFile);
+    wavFile = nullptr;
+}
+
+#ifdef _WIN32
+static HWAVEOUT device = nullptr;
+static HANDLE deviceEvent = nullptr;
+static WAVEHDR deviceHeaders[8];
+static std::vector<short> deviceBlocks;
+
+static bool openDevice() {
+    WAVEFORMATEX format = {};
+    format.wFormatTag = WAVE_FORMAT_PCM;
+    format.nChannels = 2;
+    format.nSamplesPerSec = config.rate;
+    format.wBitsPerSample = 16;
+    format.nBlockAlign = 4;
+    format.nAvgBytesPerSec = config.rate * 4;
+
+    deviceEvent = CreateEvent(nullptr, FALSE, FALSE, nullptr);
+    if (!deviceEvent || waveOutOpen(&device, WAVE_MAPPER, &format, reinterpret_cast<DWORD_PTR>(deviceEvent), 0, CALLBACK_EVENT) != MMSYSERR_NOERROR) {
+        fprintf(stderr, "Cannot open the audio device\n");
+        if (deviceEvent) {
+            CloseHandle(deviceEvent);
+            deviceEvent = nullptr;
+        }
+        device = nullptr;
+        return false;
+    }
+
+    deviceBlocks.assign(2 * static_cast<size_t>(config.blockFrames) * config.deviceBuffers, 0);
+    for (int i = 0; i < config.deviceBuffers; ++i) {
+        WAVEHDR& header = deviceHeaders[i];
+        header = WAVEHDR();
+        header.lpData = reinterpret_cast<LPSTR>(&deviceBlocks[2 * static_cast<size_t>(config.blockFrames) * i]);
+        header.dwBufferLength = config.blockFrames * 4;
+        waveOutPrepareHeader(device, &header, sizeof(header));
+        header.dwFlags |= WHDR_DONE;  // Free to fill
+    }
+    return true;
+}
+
+// Blocks until the device has finished with one of the queued buffers
+static WAVEHDR* nextDeviceBuffer() {
+    for (;;) {
+        for (int i = 0; i < config.deviceBuffers; ++i) {
+            if (deviceHeaders[i].dwFlags & WHDR_DONE) {
+                return &deviceHeaders[i];
+            }
+        }
+        WaitForSingleObject(deviceEvent, 100);
+    }
+}
+
+static void closeDevice() {
+    if (!device) {
+        return;
+    }
+    waveOutReset(device);
+    for (int i = 0; i < config.deviceBuffers; ++i) {
+        waveOutUnprepareHeader(device, &deviceHeaders[i], sizeof(WAVEHDR));
+    }
+    waveOutClose(device);
+    CloseHandle(deviceEvent);
+    device = nullptr;
+    deviceEvent = nullptr;
+}
+#endif
+
+static void recordLatency(long long queuedNs, long long playedNs) {
+    long long latency = playedNs - queuedNs;
+    counters.latencyTotalNs.fetch_add(latency, std::memory_order_relaxed);
+    if (latency > counters.latencyMaxNs.load(std::memory_order_relaxed)) {
+        counters.latencyMaxNs.store(latency, std::memory_order_relaxed);
+    }
+}
+
+static void mixLoop() {
+    using namespace std::chrono;
+    std::vector<float> mix(2 * static_cast<size_t>(config.blockFrames));
+    std::vector<short> block(2 * static_cast<size_t>(config.blockFrames));
+    long long queued[COMMAND_QUEUE_SIZE];
+    nanoseconds blockTime(1000000000LL * config.blockFrames / config.rate);
+    steady_clock::time_point deadline = steady_clock::now();
+
+    while (running.load(std::memory_order_acquire)) {
+        // Wait for the output to want a block before taking commands, so
+        // a click lands in the very next block that goes out
+        short* out = block.data();
+#ifdef _WIN32
+        WAVEHDR* header = nullptr;
+        if (device) {
+            header = nextDeviceBuffer();
+            out = reinterpret_cast<short*>(header->lpData);
+        }
+        else
+#endif
+        {
+            deadline += blockTime;
+            steady_clock::time_point now = steady_clock::now();
+            if (now > deadline + blockTime) {
+                // Fell behind; start again from now rather than rush to catch up
+                counters.lateBlocks.fetch_add(1, std::memory_order_relaxed);
+                deadline = now;
+            }
+            std::this_thread::sleep_until(deadline);
+        }
+
+        int started = 0;
+        PlayCommand command;
+        while (started < COMMAND_QUEUE_SIZE && commands.pop(command)) {
+            if (startVoice(command)) {
+                queued[started++] = command.queuedNs;
+            }
+        }
+
+        mixBlock(mix.data(), out, config.blockFrames);
+#ifdef _WIN32
+        if (header) {
+            header->dwFlags &= ~WHDR_DONE;
+            waveOutWrite(device, header, sizeof(WAVEHDR));
+        }
+#endif
+        if (wavFile) {
+            fwrite(out, 4, config.blockFrames, wavFile);
+            wavFrames += config.blockFrames;
+        }
+
+        long long playedNs = nowNs();
+        for (int i = 0; i < started; ++i) {
+            recordLatency(queued[i], playedNs);
+        }
+        counters.blocks.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+bool startAudio(const AudioConfig& newConfig, const Sound* sounds, int soundCount) {
+    if (running.load()) {
+        fprintf(stderr, "Audio is already running\n");
+        return false;
+    }
+    if (newConfig.rate <= 0 || newConfig.blockFrames <= 0 || newConfig.deviceBuffers < 2 || newConfig.deviceBuffers > 8) {
+        fprintf(stderr, "Bad audio configuration\n");
+        return false;
+    }
+    for (int i = 0; i < soundCount; ++i) {
+        if (sounds[i].rate != newConfig.rate) {
+            fprintf(stderr, "Sound %d is at %d Hz, the mixer runs at %d Hz\n", i, sounds[i].rate, newConfig.rate);
+            return false;
+        }
+    }
+
+    config = newConfig;
+    bank = sounds;
+    bankSize = soundCount;
+    for (Voice& voice : voices) {
+        voice = Voice();
+    }
+
+    if (config.output == AUDIO_WAV_FILE) {
+        wavFile = config.wavPath ? fopen(config.wavPath, "wb") : nullptr;
+        if (!wavFile) {
+            fprintf(stderr, "Cannot write %s\n", config.wavPath ? config.wavPath : "(no path)");
+            return false;
+        }
+        wavFrames = 0;
+        writeWavHeader(wavFile, config.rate, 0);
+    }
+    else if (config.output == AUDIO_DEVICE) {
+#ifdef _WIN32
+        if (!openDevice()) {
+            return false;
+        }
+#else
+        fprintf(stderr, "No audio device output on this platform, mixing to the null output\n");
+        config.output = AUDIO_NULL;
+#endif
+    }
+
+    running.store(true, std::memory_order_release);
+    mixer = std::thread(mixLoop);
+    return true;
+}
+
+void stopAudio() {
+    if (!running.load()) {
+        return;
+    }
+    running.store(false, std::memory_order_release);
+    mixer.join();
+    finishWav();
+#ifdef _WIN32
+    closeDevice();
+#endif
+}
+
+bool playSound(int sound, float gain) {
+    if (!running.load(std::memory_order_acquire)) {
+        return false;
+    }
+    PlayCommand command = {sound, gain, nowNs()};
+    if (!commands.push(command)) {
+        counters.commandsDropped.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    return true;
+}
+
+AudioStats audioStats() {
+    AudioStats stats;
+    stats.blocks = counters.blocks.load(std::memory_order_relaxed);
+    stats.voicesStarted = counters.voicesStarted.load(std::memory_order_relaxed);
+    stats.voicesStolen = counters.voicesStolen.load(std::memory_order_relaxed);
+    stats.commandsDropped = counters.commandsDropped.load(std::memory_order_relaxed);
+    stats.lateBlocks = counters.lateBlocks.load(std::memory_order_relaxed);
+    if (stats.voicesStarted > 0) {
+        stats.latencyMeanMs = counters.latencyTotalNs.load(std::memory_order_relaxed) / 1e6 / stats.voicesStarted;
+    }
+    stats.latencyMaxMs = counters.latencyMaxNs.load(std::memory_order_relaxed) / 1e6;
+    if (config.output == AUDIO_DEVICE) {
+        stats.deviceLatencyMs = 1000.0 * (config.deviceBuffers - 1) * config.blockFrames / config.rate;
+    }
+    return stats;
+}
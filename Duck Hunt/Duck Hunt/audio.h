@@ -0,0 +1,49 @@
+#pragma once
+#include "sound.h"
+
+// Sound effects mixed on a dedicated thread. The game thread only calls
+// playSound(), which puts a command on a wait-free queue: no lock, no
+// allocation and no waiting, however fast the player fires. The mixer
+// thread owns every voice. Before each block it takes the queued commands,
+// then mixes the playing voices into the block, so a shot starts within one
+// block of the click plus whatever the output device buffers.
+enum AudioOutput {
+    AUDIO_NULL,      // Mixes in real time and throws the result away
+    AUDIO_WAV_FILE,  // Mixes in real time into a 16-bit stereo WAV file
+    AUDIO_DEVICE     // The sound card through waveOut; null elsewhere
+};
+
+struct AudioConfig {
+    AudioOutput output = AUDIO_DEVICE;
+    const char* wavPath = nullptr;  // AUDIO_WAV_FILE only
+    int rate = 44100;
+    int blockFrames = 128;          // 2.9 ms at 44.1 kHz
+    int deviceBuffers = 3;          // Blocks queued ahead on the device
+};
+
+const int MAX_VOICES = 32;  // Past this the oldest voice is cut off
+
+// Starts the mixer over a bank of sounds, which must stay alive and
+// unchanged until stopAudio(). Every sound must be at config.rate.
+bool startAudio(const AudioConfig& config, const Sound* sounds, int soundCount);
+
+// Stops the mixer thread and finishes the WAV file, if any.
+void stopAudio();
+
+// Starts sound from the bank at the next block. Call from one thread only.
+// Returns false if the mixer is not running or the command queue is full.
+bool playSound(int sound, float gain = 1.0f);
+
+struct AudioStats {
+    long long blocks = 0;
+    long long voicesStarted = 0;
+    long long voicesStolen = 0;     // Cut off to make room
+    long long commandsDropped = 0;  // Queue full, never played
+    long long lateBlocks = 0;       // Mixer fell behind real time
+    double latencyMeanMs = 0.0;     // playSound() to its block going out
+    double latencyMaxMs = 0.0;
+    double deviceLatencyMs = 0.0;   // Extra delay of the blocks queued ahead
+};
+
+// Safe to call while the mixer runs.
+AudioStats audioStats();
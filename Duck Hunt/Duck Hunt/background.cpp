@@ -0,0 +1,165 @@
+#include "background.h"
+#include "gl_ext.h"
+#include "shapes.h"
+#include "simulation.h"
+#include "unit_circle.h"
+
+static void buildBackground(ShapeList& list) {
+    // Sky
+    beginShape(list, SHAPE_QUADS, 0.5f, 0.8f, 1.0f);
+    addPoint(list, 0, 0);
+    addPoint(list, WINDOW_WIDTH, 0);
+    addPoint(list, WINDOW_WIDTH, WINDOW_HEIGHT);
+    addPoint(list, 0, WINDOW_HEIGHT);
+
+    // Sky grid lines
+    beginShape(list, SHAPE_LINES, 0.6f, 0.85f, 1.0f, 0.5f);
+    for (int i = 0; i < WINDOW_WIDTH; i += 40) {
+        addPoint(list, i, WINDOW_HEIGHT / 5);
+        addPoint(list, i, WINDOW_HEIGHT);
+    }
+    for (int i = WINDOW_HEIGHT / 5; i < WINDOW_HEIGHT; i += 40) {
+        addPoint(list, 0, i);
+        addPoint(list, WINDOW_WIDTH, i);
+    }
+
+    // Sand/ground
+    beginShape(list, SHAPE_QUADS, 0.9f, 0.9f, 0.0f);
+    addPoint(list, 0, WINDOW_HEIGHT / 5);
+    addPoint(list, WINDOW_WIDTH, WINDOW_HEIGHT / 5);
+    addPoint(list, WINDOW_WIDTH, WINDOW_HEIGHT / 3.5);
+    addPoint(list, 0, WINDOW_HEIGHT / 3.5);
+
+    // Grass tufts on sand
+    for (int i = 10; i < WINDOW_WIDTH; i += 30) {
+        beginShape(list, SHAPE_TRIANGLES, 0.7f, 0.8f, 0.0f);
+        addPoint(list, i, WINDOW_HEIGHT / 3.5);
+        addPoint(list, i + 5, WINDOW_HEIGHT / 3.2);
+        addPoint(list, i + 10, WINDOW_HEIGHT / 3.5);
+    }
+
+    // Dirt/ground
+    beginShape(list, SHAPE_QUADS, 0.6f, 0.3f, 0.0f);
+    addPoint(list, 0, 0);
+    addPoint(list, WINDOW_WIDTH, 0);
+    addPoint(list, WINDOW_WIDTH, WINDOW_HEIGHT / 5);
+    addPoint(list, 0, WINDOW_HEIGHT / 5);
+
+    // Tree trunk - Draw as a single rectangle that extends up to the leaves
+    beginShape(list, SHAPE_QUADS, 0.8f, 0.2f, 0.0f);
+    addPoint(list, 120, WINDOW_HEIGHT / 3.5);  // Start at ground level
+    addPoint(list, 140, WINDOW_HEIGHT / 3.5);
+    addPoint(list, 140, WINDOW_HEIGHT / 1.6);  // Extend higher to connect with leaves
+    addPoint(list, 120, WINDOW_HEIGHT / 1.6);
+
+    // Tree branch
+    beginShape(list, SHAPE_QUADS, 0.8f, 0.2f, 0.0f);
+    addPoint(list, 140, WINDOW_HEIGHT / 1.7);
+    addPoint(list, 180, WINDOW_HEIGHT / 1.7);
+    addPoint(list, 180, WINDOW_HEIGHT / 1.6);
+    addPoint(list, 140, WINDOW_HEIGHT / 1.6);
+
+    // Tree leaves (four green circles)
+    for (int cx = 0; cx < 2; cx++) {
+        for (int cy = 0; cy < 2; cy++) {
+            beginShape(list, SHAPE_POLYGON, 0.7f, 0.9f, 0.0f);
+            float centerX = 130 + cx * 50;
+            float centerY = WINDOW_HEIGHT / 1.6 + cy * 60;  // Adjust to connect with trunk
+            float radius = 30;
+            for (int i = 0; i < 12; i++) {
+                addPoint(list, centerX + radius * UnitCircle<12>::cos[i], centerY + radius * UnitCircle<12>::sin[i]);
+            }
+        }
+    }
+
+    // Bush
+    beginShape(list, SHAPE_POLYGON, 0.7f, 0.9f, 0.0f);
+    float bushX = WINDOW_WIDTH - 100;
+    float bushY = WINDOW_HEIGHT / 3.5 + 30;
+    float bushRadius = 40;
+    for (int i = 0; i < 12; i++) {
+        addPoint(list, bushX + bushRadius * UnitCircle<12>::cos[i], bushY + bushRadius * UnitCircle<12>::sin[i]);
+    }
+}
+
+const ShapeList& backgroundShapes() {
+    static ShapeList list;
+    if (list.shapes.empty()) {
+        buildBackground(list);
+    }
+    return list;
+}
+
+// The layer is copied into the lower-left corner of a power-of-two texture
+// so it works without NPOT texture support.
+static GLuint layerTexture = 0;
+static int layerWidth = 0;
+static int layerHeight = 0;
+static int textureWidth = 0;
+static int textureHeight = 0;
+static bool layerValid = false;
+
+static int nextPowerOfTwo(int n) {
+    int p = 1;
+    while (p < n) {
+        p *= 2;
+    }
+    return p;
+}
+
+static void bakeBackground() {
+    GLint viewport[4];
+    glGetIntegerv(GL_VIEWPORT, viewport);
+
+    drawShapes(backgroundShapes());
+
+    if (!layerTexture) {
+        glGenTextures(1, &layerTexture);
+    }
+    glBindTexture(GL_TEXTURE_2D, layerTexture);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP);
+
+    layerWidth = viewport[2];
+    layerHeight = viewport[3];
+    if (nextPowerOfTwo(layerWidth) != textureWidth || nextPowerOfTwo(layerHeight) != textureHeight) {
+        textureWidth = nextPowerOfTwo(layerWidth);
+        textureHeight = nextPowerOfTwo(layerHeight);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, textureWidth, textureHeight, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+    }
+    glCopyTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, viewport[0], viewport[1], layerWidth, layerHeight);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    layerValid = glGetError() == GL_NO_ERROR;
+}
+
+void drawBackground() {
+    if (!layerValid) {
+        bakeBackground();
+        return;
+    }
+
+    float u = static_cast<float>(layerWidth) / textureWidth;
+    float v = static_cast<float>(layerHeight) / textureHeight;
+
+    glEnable(GL_TEXTURE_2D);
+    glBindTexture(GL_TEXTURE_2D, layerTexture);
+    glTexEnvi(GL_TEXTURE_ENV, GL_TEXTURE_ENV_MODE, GL_REPLACE);
+    glBegin(GL_QUADS);
+    glTexCoord2f(0.0f, 0.0f);
+    glVertex2f(0, 0);
+    glTexCoord2f(u, 0.0f);
+    glVertex2f(WINDOW_WIDTH, 0);
+    glTexCoord2f(u, v);
+    glVertex2f(WINDOW_WIDTH, WINDOW_HEIGHT);
+    glTexCoord2f(0.0f, v);
+    glVertex2f(0, WINDOW_HEIGHT);
+    glEnd();
+    glBindTexture(GL_TEXTURE_2D, 0);
+    glDisable(GL_TEXTURE_2D);
+}
+
+void invalidateBackground() {
+    layerValid = false;
+}
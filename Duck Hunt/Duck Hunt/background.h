@@ -0,0 +1,13 @@
+#pragma once
+#include "shapes.h"
+
+// Draws the sky, ground, tree and bush. None of it changes, so the first
+// call after invalidateBackground() renders the scenery and copies the
+// result into a texture; every later call is a single textured quad.
+void drawBackground();
+
+// Call when the viewport changes size.
+void invalidateBackground();
+
+// The scenery as geometry, for renderers that bake it themselves.
+const ShapeList& backgroundShapes();
@@ -0,0 +1,253 @@
+// Plays many independent sessions in parallel for balancing runs and prints
+// the score and accuracy distributions over every finished game.
+//
+//   duckhunt_batch [--sessions N] [--games N] [--threads N] [--seed N]
+//                  [--shoot-every N] [--spread PIXELS] [--ducks N]
+//                  [--spawn-rate N] [--mode classic|swarm|sniper|stress]
+//                  [--bot] [--reaction TICKS] [--cooldown TICKS]
+//
+// The scripted shooter misses its mark by up to --spread pixels on each
+// axis, so the distributions show how forgiving SHOT_RADIUS and the bonus
+// window are. --bot plays with the predictive bot instead, for an upper
+// bound on the score.
+//
+// Session i is seeded with seed + i and results are gathered by session, so
+// the report is the same whatever the thread count; only the time changes.
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+#include "simulation.h"
+#include "replay.h"
+#include "bot.h"
+#include "task_pool.h"
+
+struct BatchOptions {
+    int sessions = 256;
+    int games = 100;          // Finished games per session
+    int threads = 0;          // 0: one per hardware thread
+    uint64_t seed = 1;
+    int shootEvery = 30;
+    int spread = 60;
+    int maxDucks = 0;         // 0: the mode's
+    int spawnsPerTick = 0;    // Likewise
+    int mode = MODE_CLASSIC;
+    bool useBot = false;
+    BotConfig bot;
+};
+
+struct GameResult {
+    int score;
+    int hits;
+    int shots;
+};
+
+struct SessionResult {
+    std::vector<GameResult> games;
+    long long ticks = 0;
+};
+
+static void countGameEnd(SessionResult& result, const World& world, bool& over) {
+    bool nowOver = world.gameOver || world.roundOver;
+    if (nowOver && !over) {
+        GameResult game = {world.score, world.totalShots - world.missedShots, world.totalShots};
+        result.games.push_back(game);
+    }
+    over = nowOver;
+}
+
+static void playBotSession(const BatchOptions& options, World& world, SessionResult& result) {
+    Bot bot;
+    bot.config = options.bot;
+    bool over = false;
+    while (static_cast<int>(result.games.size()) < options.games) {
+        updateBot(bot, world, nullptr);
+        countGameEnd(result, world, over);
+        stepWorld(world, SIM_STEP);
+        countGameEnd(result, world, over);
+    }
+}
+
+// Stream id for the shooter's aim, clear of the world's spawn streams
+const uint64_t AIM_STREAM = 100;
+
+// The scripted shooter of duckhunt_headless with a shaky hand: every
+// shootEvery ticks, fire near the duck in slot 0 of the pool (whichever
+// duck the last release moved there, not the oldest), or restart once the
+// game or round is over.
+static void playSession(const BatchOptions& options, uint64_t seed, SessionResult& result) {
+    Pcg32 aim;
+    seedRandom(aim, seed, AIM_STREAM);
+
+    InputLog start;
+    start.seed = seed;
+    start.mode = options.mode;
+    start.maxDucks = options.maxDucks;
+    start.spawnsPerTick = options.spawnsPerTick;
+    World world;
+    startFromLog(world, start);
+
+    result.games.reserve(options.games);
+    if (options.useBot) {
+        playBotSession(options, world, result);
+        result.ticks = world.tick;
+        return;
+    }
+
+    while (static_cast<int>(result.games.size()) < options.games) {
+        stepWorld(world, SIM_STEP);
+        if (world.tick % options.shootEvery != 0) {
+            continue;
+        }
+
+        int x = 0, y = 0;
+        if (world.gameOver || world.roundOver) {
+            GameResult game = {world.score, world.totalShots - world.missedShots, world.totalShots};
+            result.games.push_back(game);
+        }
+        else {
+            if (world.ducks.count == 0) {
+                continue;
+            }
+            float offsetX = options.spread * (2.0f * randomFloat(aim) - 1.0f);
+            float offsetY = options.spread * (2.0f * randomFloat(aim) - 1.0f);
+            x = static_cast<int>(std::floor(world.ducks.x[0] + offsetX + 0.5f));
+            y = static_cast<int>(std::floor(world.ducks.y[0] + offsetY + 0.5f));
+        }
+        submitInput(world, nullptr, INPUT_SHOT, x, y);
+    }
+    result.ticks = world.tick;
+}
+
+static double percentile(const std::vector<double>& sorted, double p) {
+    size_t index = static_cast<size_t>(p * (sorted.size() - 1) + 0.5);
+    return sorted[index];
+}
+
+// Summary line plus a text histogram of bins equal-width buckets on
+// [low, high], printing values with the given number of decimals.
+static void printDistribution(const char* name, std::vector<double> values, double low, double high, int bins, int decimals) {
+    std::sort(values.begin(), values.end());
+    double sum = 0.0;
+    for (double value : values) {
+        sum += value;
+    }
+    double mean = sum / values.size();
+    double variance = 0.0;
+    for (double value : values) {
+        variance += (value - mean) * (value - mean);
+    }
+    double deviation = std::sqrt(variance / values.size());
+
+    const int width = 7;
+    printf("%s\n", name);
+    printf("  mean %.*f  sd %.*f  min %.*f  p10 %.*f  p50 %.*f  p90 %.*f  max %.*f\n",
+        decimals, mean, decimals, deviation, decimals, values.front(),
+        decimals, percentile(values, 0.1), decimals, percentile(values, 0.5),
+        decimals, percentile(values, 0.9), decimals, values.back());
+
+    std::vector<long long> counts(bins, 0);
+    for (double value : values) {
+        int bin = static_cast<int>((value - low) / (high - low) * bins);
+        counts[std::max(0, std::min(bins - 1, bin))]++;
+    }
+    long long largest = *std::max_element(counts.begin(), counts.end());
+    for (int i = 0; i < bins; ++i) {
+        double from = low + (high - low) * i / bins;
+        double to = low + (high - low) * (i + 1) / bins;
+        printf("  %*.*f - %*.*f %8lld ", width, decimals, from, width, decimals, to, counts[i]);
+        int bar = largest > 0 ? static_cast<int>(40 * counts[i] / largest) : 0;
+        for (int j = 0; j < bar; ++j) {
+            putchar('#');
+        }
+        putchar('\n');
+    }
+}
+
+int main(int argc, char** argv) {
+    BatchOptions options;
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "--sessions") == 0 && i + 1 < argc) {
+            options.sessions = atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--games") == 0 && i + 1 < argc) {
+            options.games = atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+            options.threads = atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc) {
+            options.seed = strtoull(argv[++i], nullptr, 10);
+        }
+        else if (strcmp(argv[i], "--shoot-every") == 0 && i + 1 < argc) {
+            options.shootEvery = atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--spread") == 0 && i + 1 < argc) {
+            options.spread = atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--ducks") == 0 && i + 1 < argc) {
+            options.maxDucks = atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--spawn-rate") == 0 && i + 1 < argc) {
+            options.spawnsPerTick = atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--mode") == 0 && i + 1 < argc && findGameMode(argv[i + 1]) != -1) {
+            options.mode = findGameMode(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--bot") == 0) {
+            options.useBot = true;
+        }
+        else if (strcmp(argv[i], "--reaction") == 0 && i + 1 < argc) {
+            options.bot.reactionTicks = atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--cooldown") == 0 && i + 1 < argc) {
+            options.bot.cooldownTicks = atoi(argv[++i]);
+        }
+        else {
+            fprintf(stderr, "usage: %s [--sessions N] [--games N] [--threads N] [--seed N] [--shoot-every N] [--spread PIXELS] [--ducks N] [--spawn-rate N] [--mode classic|swarm|sniper|stress] [--bot] [--reaction TICKS] [--cooldown TICKS]\n", argv[0]);
+            return 2;
+        }
+    }
+    if (options.sessions <= 0 || options.games <= 0 || options.shootEvery <= 0) {
+        fprintf(stderr, "--sessions, --games and --shoot-every must be positive\n");
+        return 2;
+    }
+
+    std::vector<SessionResult> results(options.sessions);
+    TaskPool pool(options.threads);
+
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < options.sessions; ++i) {
+        SessionResult* result = &results[i];
+        uint64_t seed = options.seed + i;
+        pool.submit([&options, seed, result] { playSession(options, seed, *result); });
+    }
+    pool.wait();
+    auto end = std::chrono::steady_clock::now();
+
+    std::vector<double> scores;
+    std::vector<double> accuracies;
+    long long ticks = 0;
+    for (const SessionResult& result : results) {
+        for (const GameResult& game : result.games) {
+            scores.push_back(game.score);
+            accuracies.push_back(game.shots > 0 ? static_cast<double>(game.hits) / game.shots : 0.0);
+        }
+        ticks += result.ticks;
+    }
+
+    double seconds = std::chrono::duration<double>(end - start).count();
+    printf("threads:      %d (%lld steals)\n", pool.threads(), pool.steals());
+    printf("sessions:     %d x %d games\n", options.sessions, options.games);
+    printf("elapsed:      %.3f s\n", seconds);
+    printf("games/sec:    %.0f\n", seconds > 0.0 ? scores.size() / seconds : 0.0);
+    printf("ticks/sec:    %.0f\n", seconds > 0.0 ? ticks / seconds : 0.0);
+
+    printf("mode:         %s\n", gameMode(options.mode).name);
+    printDistribution("score:", scores, 0.0, gameMode(options.mode).bestScore, 10, 0);
+    printDistribution("accuracy:", accuracies, 0.0, 1.0, 10, 2);
+    return 0;
+}
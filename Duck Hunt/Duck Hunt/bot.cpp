@@ -0,0 +1,68 @@
+#include "bot.h"
+#include <algorithm>
+#include <cmath>
+
+static void fire(Bot& bot, World& world, InputLog* log, int x, int y) {
+    submitInput(world, log, INPUT_SHOT, x, y);
+    bot.aiming = false;
+    bot.readyTick = world.tick + bot.config.cooldownTicks;
+}
+
+// Picks the duck that can be hit at fireTick closest to the crosshair, so
+// the mouse travels as little as a player's would. Returns false if every
+// duck will be gone or outside the window by then.
+static bool pickTarget(Bot& bot, const World& world, long long fireTick) {
+    const DuckPool& ducks = world.ducks;
+    int steps = static_cast<int>(fireTick - world.tick);
+    bool found = false;
+    float bestDistance = 0.0f;
+
+    for (int i = 0; i < ducks.count; ++i) {
+        float x, y;
+        if (!predictDuck(ducks, i, steps, 1.0f, x, y)) {
+            continue;
+        }
+        int aimX = static_cast<int>(std::floor(x + 0.5f));
+        int aimY = static_cast<int>(std::floor(y + 0.5f));
+        if (aimX < 0 || aimX >= WINDOW_WIDTH || aimY < 0 || aimY >= WINDOW_HEIGHT) {
+            continue;
+        }
+
+        float dx = static_cast<float>(aimX - world.pointerX);
+        float dy = static_cast<float>(aimY - world.pointerY);
+        float distance = dx * dx + dy * dy;
+        if (!found || distance < bestDistance) {
+            found = true;
+            bestDistance = distance;
+            bot.aimX = aimX;
+            bot.aimY = aimY;
+        }
+    }
+    return found;
+}
+
+void updateBot(Bot& bot, World& world, InputLog* log) {
+    if (world.gameOver || world.roundOver) {
+        // Click through to the next game
+        bot.aiming = false;
+        if (world.tick >= bot.readyTick) {
+            fire(bot, world, log, world.pointerX, world.pointerY);
+        }
+        return;
+    }
+
+    if (!bot.aiming) {
+        // The earliest shot is the best one: points only go down with time
+        long long fireTick = std::max(world.tick + bot.config.reactionTicks, bot.readyTick);
+        if (!pickTarget(bot, world, fireTick)) {
+            return;
+        }
+        bot.aiming = true;
+        bot.fireTick = fireTick;
+        submitInput(world, log, INPUT_MOTION, bot.aimX, bot.aimY);
+    }
+
+    if (world.tick >= bot.fireTick) {
+        fire(bot, world, log, bot.aimX, bot.aimY);
+    }
+}
@@ -0,0 +1,27 @@
+#pragma once
+#include "replay.h"
+
+// Built-in player for load tests and for a reproducible upper bound on the
+// score. It plays through submitInput() like the mouse callbacks, but with a
+// reaction time: the target is picked reactionTicks before the shot lands,
+// from where each duck will be by then (see predictDuck()). It only pulls
+// the trigger on a predicted hit, so none of the SHOTS_PER_ROUND is wasted,
+// and it fires as soon as it can because the time bonus only ever decays.
+struct BotConfig {
+    int reactionTicks = 12;  // From picking a target to the shot landing
+    int cooldownTicks = 15;  // Shortest time between two shots
+};
+
+struct Bot {
+    BotConfig config;
+
+    bool aiming = false;     // A shot is planned
+    long long fireTick = 0;  // Tick the planned shot lands on
+    int aimX = 0, aimY = 0;
+    long long readyTick = 0; // Earliest tick the next shot may land on
+};
+
+// Gives the bot its turn at the world's current tick. Call before
+// stepWorld(), after any other input for the tick. Input also goes to log
+// when there is one.
+void updateBot(Bot& bot, World& world, InputLog* log);
@@ -0,0 +1,7 @@
+#pragma once
+#include "text_renderer.h"
+
+// A GlyphSource that needs no windowing library: one 5x7 pixel font built
+// into the program, drawn at the size of each TextFont it stands in for.
+// For offscreen tools running where GLUT cannot open a display.
+extern const GlyphSource builtinGlyphSource;
@@ -0,0 +1,241 @@
+// Renders a recorded or bot-played session offscreen and exports it as
+// video, for attract-mode loops and regression footage. Needs no display:
+// frames are drawn into a surfaceless EGL pbuffer, by GL or by the
+// software rasterizer, on a fixed timeline of --fps frames per second of
+// game time, as fast as the machine allows.
+//
+//   duckhunt_capture [--replay PATH | --bot] [--seed N] [--mode M] [--ducks N]
+//                    [--seconds S] [--fps N] [--renderer gl|soft]
+//                    [--render-threads N] [--format png|y4m|raw] [--out PATH]
+//                    [--encoders N] [--queue N]
+//
+// --replay plays a log to its end; otherwise the bot plays --seconds of a
+// fresh game. GL frames are read back through pixel buffers a few frames
+// late, so the drawing thread never waits on the GPU; encoding runs on
+// its own threads (see video_export.h).
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include "bot.h"
+#include "builtin_font.h"
+#include "duck_renderer.h"
+#include "frame.h"
+#include "frame_readback.h"
+#include "game_loop.h"
+#include "gl_ext.h"
+#include "replay.h"
+#include "soft_renderer.h"
+#include "text_renderer.h"
+#include "video_export.h"
+
+static double secondsNow() {
+    using namespace std::chrono;
+    return duration<double>(steady_clock::now().time_since_epoch()).count();
+}
+
+static GlProc eglProc(const char* name) {
+    return reinterpret_cast<GlProc>(eglGetProcAddress(name));
+}
+
+// A WINDOW_WIDTH x WINDOW_HEIGHT pbuffer on a surfaceless display, set up
+// the way the game's reshape() leaves its window.
+static bool offscreenContext() {
+    PFNEGLGETPLATFORMDISPLAYEXTPROC getPlatformDisplay =
+        reinterpret_cast<PFNEGLGETPLATFORMDISPLAYEXTPROC>(eglGetProcAddress("eglGetPlatformDisplayEXT"));
+    EGLDisplay display = getPlatformDisplay ? getPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, nullptr) : EGL_NO_DISPLAY;
+    EGLint major, minor;
+    if (display == EGL_NO_DISPLAY || !eglInitialize(display, &major, &minor) || !eglBindAPI(EGL_OPENGL_API)) {
+        return false;
+    }
+    const EGLint configAttributes[] = {
+        EGL_SURFACE_TYPE, EGL_PBUFFER_BIT, EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT,
+        EGL_RED_SIZE, 8, EGL_GREEN_SIZE, 8, EGL_BLUE_SIZE, 8, EGL_NONE
+    };
+    const EGLint surfaceAttributes[] = {EGL_WIDTH, WINDOW_WIDTH, EGL_HEIGHT, WINDOW_HEIGHT, EGL_NONE};
+    EGLConfig config;
+    EGLint configs = 0;
+    if (!eglChooseConfig(display, configAttributes, &config, 1, &configs) || configs == 0) {
+        return false;
+    }
+    EGLSurface surface = eglCreatePbufferSurface(display, config, surfaceAttributes);
+    EGLContext context = eglCreateContext(display, config, EGL_NO_CONTEXT, nullptr);
+    if (surface == EGL_NO_SURFACE || context == EGL_NO_CONTEXT || !eglMakeCurrent(display, surface, surface, context)) {
+        return false;
+    }
+
+    glViewport(0, 0, WINDOW_WIDTH, WINDOW_HEIGHT);
+    glMatrixMode(GL_PROJECTION);
+    glLoadIdentity();
+    glOrtho(0, WINDOW_WIDTH, 0, WINDOW_HEIGHT, -1, 1);
+    glMatrixMode(GL_MODELVIEW);
+    return true;
+}
+
+int main(int argc, char** argv) {
+    const char* replayPath = nullptr;
+    InputLog start;
+    start.seed = 1;
+    start.mode = MODE_CLASSIC;
+    double seconds = 10.0;
+    int fps = 60;
+    int renderer = RENDER_GL;
+    int renderThreads = 0;
+    VideoConfig video;
+    video.width = WINDOW_WIDTH;
+    video.height = WINDOW_HEIGHT;
+    Bot bot;
+
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "--replay") == 0 && i + 1 < argc) {
+            replayPath = argv[++i];
+        }
+        else if (strcmp(argv[i], "--bot") == 0) {
+            // The default when there is no replay
+        }
+        else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc) {
+            start.seed = strtoull(argv[++i], nullptr, 10);
+        }
+        else if (strcmp(argv[i], "--mode") == 0 && i + 1 < argc && findGameMode(argv[i + 1]) != -1) {
+            start.mode = findGameMode(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--ducks") == 0 && i + 1 < argc) {
+            start.maxDucks = atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--seconds") == 0 && i + 1 < argc) {
+            seconds = atof(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--fps") == 0 && i + 1 < argc && atoi(argv[i + 1]) > 0) {
+            fps = atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--renderer") == 0 && i + 1 < argc && findRenderBackend(argv[i + 1]) != -1) {
+            renderer = findRenderBackend(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--render-threads") == 0 && i + 1 < argc) {
+            renderThreads = atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--format") == 0 && i + 1 < argc && findVideoFormat(argv[i + 1]) != -1) {
+            video.format = static_cast<VideoFormat>(findVideoFormat(argv[++i]));
+        }
+        else if (strcmp(argv[i], "--out") == 0 && i + 1 < argc) {
+            video.path = argv[++i];
+        }
+        else if (strcmp(argv[i], "--encoders") == 0 && i + 1 < argc) {
+            video.encoders = atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--queue") == 0 && i + 1 < argc) {
+            video.queueFrames = atoi(argv[++i]);
+        }
+        else {
+            fprintf(stderr, "usage: %s [--replay PATH | --bot] [--seed N] [--mode classic|swarm|sniper|stress] [--ducks N] [--seconds S] [--fps N] [--renderer gl|soft] [--render-threads N] [--format png|y4m|raw] [--out PATH] [--encoders N] [--queue N]\n", argv[0]);
+            return 2;
+        }
+    }
+    if (!video.path) {
+        static const char* const defaultPaths[VIDEO_FORMAT_COUNT] = {"capture%05d.png", "capture.y4m", "capture.rgb"};
+        video.path = defaultPaths[video.format];
+    }
+    video.fps = fps;
+    // Streaming to stdout leaves the report to stderr
+    FILE* report = strcmp(video.path, "-") == 0 ? stderr : stdout;
+
+    InputLog log;
+    World world;
+    GameLoop loop;
+    if (replayPath) {
+        if (!readInputLog(replayPath, log)) {
+            fprintf(stderr, "cannot read replay log %s\n", replayPath);
+            return 2;
+        }
+        startFromLog(world, log);
+        loop.replay = &log;
+    }
+    else {
+        startFromLog(world, start);
+        loop.bot = &bot;
+    }
+
+    if (!offscreenContext()) {
+        fprintf(stderr, "no surfaceless EGL context\n");
+        return 1;
+    }
+    loadGlExtensions(eglProc);
+    initDuckRenderer(eglProc);
+    if (!initTextRenderer(builtinGlyphSource)) {
+        fprintf(stderr, "pbuffer too small for the glyph atlas\n");
+        return 1;
+    }
+    bool gl = renderer == RENDER_GL;
+    bool asynchronous = gl && initFrameReadback(WINDOW_WIDTH, WINDOW_HEIGHT);
+    if (renderer == RENDER_SOFT) {
+        initSoftRenderer(renderThreads);
+    }
+    if (!startVideoExport(video)) {
+        return 1;
+    }
+
+    // Game time runs off the frame count, so every run of the same session
+    // gives the same frames however fast it goes
+    const RenderBackend& backend = renderBackend(renderer);
+    advanceGameLoop(loop, world, 0.0);
+    long long frames = 0;
+    double drawMs = 0.0;
+    double begin = secondsNow();
+    for (;;) {
+        double time = static_cast<double>(frames) / fps;
+        bool finished = replayPath ? world.tick >= log.endTick : time >= seconds;
+        if (finished) {
+            break;
+        }
+        advanceGameLoop(loop, world, time);
+
+        double drawBegin = secondsNow();
+        if (gl) {
+            glClear(GL_COLOR_BUFFER_BIT);
+        }
+        backend.drawScene(world, interpolationAlpha(loop));
+        backend.drawCrosshair(world.pointerX, world.pointerY);
+        if (gl) {
+            readFrame();
+            // Hands over the frame from a few frames back, if it is due
+            unsigned char* pixels = videoFrame();
+            if (takeReadFrame(pixels, false)) {
+                submitVideoFrame();
+            }
+        }
+        else {
+            memcpy(videoFrame(), softFramebuffer(), static_cast<size_t>(WINDOW_WIDTH) * WINDOW_HEIGHT * 4);
+            submitVideoFrame();
+        }
+        drawMs += (secondsNow() - drawBegin) * 1000.0;
+        frames++;
+    }
+    if (gl) {
+        for (;;) {
+            unsigned char* pixels = videoFrame();
+            if (!takeReadFrame(pixels, true)) {
+                break;
+            }
+            submitVideoFrame();
+        }
+    }
+    if (renderer == RENDER_SOFT) {
+        shutdownSoftRenderer();
+    }
+    shutdownFrameReadback();
+    bool written = finishVideoExport();
+    double elapsed = secondsNow() - begin;
+
+    VideoStats stats = videoStats();
+    double footage = static_cast<double>(frames) / fps;
+    fprintf(report, "captured:   %lld frames, %.2f s of game at %d fps, tick %lld\n", frames, footage, fps, world.tick);
+    fprintf(report, "took:       %.2f s, %.1f fps, %.1fx real time\n", elapsed, frames / elapsed, footage / elapsed);
+    fprintf(report, "renderer:   %s, %.3f ms per frame drawing%s\n", backend.name,
+        frames > 0 ? drawMs / frames : 0.0, gl ? (asynchronous ? " (pixel buffer readback)" : " (synchronous readback)") : "");
+    fprintf(report, "encoders:   %d, %.3f ms per frame, drawing blocked %.1f ms on a full queue\n",
+        stats.encoders, stats.frames > 0 ? stats.encodeMs / stats.frames : 0.0, stats.waitMs);
+    fprintf(report, "output:     %lld frames to %s\n", stats.frames, video.path);
+    return written && stats.frames == frames ? 0 : 1;
+}
@@ -0,0 +1,65 @@
+#include "duck_grid.h"
+#include "simulation.h"
+
+void reserveGrid(DuckGrid& grid, int capacity) {
+    if (grid.head.empty()) {
+        const int cellSize = ClassicRules::SHOT_RADIUS + DUCK_SIZE;
+        grid.cellScale = 1.0f / cellSize;
+        grid.columns = (WINDOW_WIDTH + cellSize - 1) / cellSize;
+        grid.rows = (WINDOW_HEIGHT + cellSize - 1) / cellSize;
+        grid.head.assign(grid.columns * grid.rows, -1);
+    }
+    grid.cell.resize(capacity, -1);
+    grid.next.resize(capacity, -1);
+    grid.prev.resize(capacity, -1);
+}
+
+void gridInsert(DuckGrid& grid, int duck, int cell) {
+    int first = grid.head[cell];
+    grid.cell[duck] = cell;
+    grid.prev[duck] = -1;
+    grid.next[duck] = first;
+    if (first != -1) {
+        grid.prev[first] = duck;
+    }
+    grid.head[cell] = duck;
+}
+
+void gridRemove(DuckGrid& grid, int duck) {
+    int next = grid.next[duck];
+    int prev = grid.prev[duck];
+    if (prev != -1) {
+        grid.next[prev] = next;
+    }
+    else {
+        grid.head[grid.cell[duck]] = next;
+    }
+    if (next != -1) {
+        grid.prev[next] = prev;
+    }
+    grid.cell[duck] = -1;
+}
+
+void gridRenumber(DuckGrid& grid, int from, int to) {
+    int next = grid.next[from];
+    int prev = grid.prev[from];
+    grid.cell[to] = grid.cell[from];
+    grid.next[to] = next;
+    grid.prev[to] = prev;
+    if (prev != -1) {
+        grid.next[prev] = to;
+    }
+    else {
+        grid.head[grid.cell[to]] = to;
+    }
+    if (next != -1) {
+        grid.prev[next] = to;
+    }
+    grid.cell[from] = -1;
+}
+
+void clearGrid(DuckGrid& grid) {
+    for (int& first : grid.head) {
+        first = -1;
+    }
+}
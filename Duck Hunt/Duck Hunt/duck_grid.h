@@ -0,0 +1,58 @@
+#pragma once
+#include <vector>
+
+// Uniform grid over the play area, used to find the ducks near a shot.
+// Cells are as wide as a classic shot's reach (SHOT_RADIUS + DUCK_SIZE), so
+// a hit test only ever looks at the 2x2 or 3x3 cells around the crosshair;
+// modes with a longer reach just search more cells. Ducks
+// outside the window are clamped into the border cells.
+//
+// Each cell is a doubly linked list threaded through per-duck next/prev
+// arrays indexed like the DuckPool, so moving a duck to another cell and
+// renumbering it on swap-and-pop are both O(1).
+struct DuckGrid {
+    int columns = 0;
+    int rows = 0;
+    float cellScale = 0.0f;  // 1 / cell size
+    std::vector<int> head;  // First duck in each cell, -1 when empty
+
+    // Per duck
+    std::vector<int> cell;
+    std::vector<int> next;
+    std::vector<int> prev;
+};
+
+void reserveGrid(DuckGrid& grid, int capacity);
+
+// The SIMD kernels in updateDucks() compute the same clamp lane-wise
+inline int gridClamp(float position, float scale, int cells) {
+    float index = position * scale;
+    if (index < 0.0f) {
+        return 0;
+    }
+    if (index > cells - 1) {
+        return cells - 1;
+    }
+    return static_cast<int>(index);
+}
+
+inline int gridColumn(const DuckGrid& grid, float x) {
+    return gridClamp(x, grid.cellScale, grid.columns);
+}
+
+inline int gridRow(const DuckGrid& grid, float y) {
+    return gridClamp(y, grid.cellScale, grid.rows);
+}
+
+inline int gridCell(const DuckGrid& grid, float x, float y) {
+    return gridRow(grid, y) * grid.columns + gridColumn(grid, x);
+}
+
+void gridInsert(DuckGrid& grid, int duck, int cell);
+void gridRemove(DuckGrid& grid, int duck);
+
+// Relinks a duck that moved from slot from to slot to. Slot to must not be
+// in the grid.
+void gridRenumber(DuckGrid& grid, int from, int to);
+
+void clearGrid(DuckGrid& grid);
@@ -0,0 +1,153 @@
+#include "duck_mesh.h"
+#include "simulation.h"
+#include "unit_circle.h"
+
+const float duckColors[2][3] = {
+    {1.0f, 1.0f, 0.0f}, // Yellow duck
+    {0.2f, 0.8f, 0.2f}  // Green duck (wings, head)
+};
+
+const float duckBodyColors[2][3] = {
+    {1.0f, 1.0f, 0.0f}, // Yellow duck body
+    {1.0f, 1.0f, 1.0f}  // White body for green duck
+};
+
+static const float orange[3] = {1.0f, 0.5f, 0.0f};
+static const float white[3] = {1.0f, 1.0f, 1.0f};
+static const float black[3] = {0.0f, 0.0f, 0.0f};
+
+const float* duckSlotColor(int slot, int color, int bodyColor) {
+    switch (slot) {
+    case DUCK_SLOT_MAIN: return duckColors[color];
+    case DUCK_SLOT_BODY: return duckBodyColors[bodyColor];
+    case DUCK_SLOT_WHITE: return white;
+    case DUCK_SLOT_BLACK: return black;
+    default: return orange;
+    }
+}
+
+static void addTriangle(std::vector<DuckVertex>& mesh, const DuckVertex& a, const DuckVertex& b, const DuckVertex& c) {
+    mesh.push_back(a);
+    mesh.push_back(b);
+    mesh.push_back(c);
+}
+
+// Convex polygons become a fan around their first vertex, the same split
+// GL_POLYGON gets.
+static void addPolygon(std::vector<DuckVertex>& mesh, const DuckVertex* points, int count) {
+    for (int i = 1; i + 1 < count; ++i) {
+        addTriangle(mesh, points[0], points[i], points[i + 1]);
+    }
+}
+
+template <int N>
+static void addEllipse(std::vector<DuckVertex>& mesh, float cx, float cy, float rx, float ry, int slot) {
+    DuckVertex points[N];
+    for (int i = 0; i < N; i++) {
+        points[i] = {cx + rx * UnitCircle<N>::cos[i], cy + ry * UnitCircle<N>::sin[i], 0.0f, static_cast<float>(slot)};
+    }
+    addPolygon(mesh, points, N);
+}
+
+static std::vector<DuckVertex> buildDuckMesh() {
+    std::vector<DuckVertex> mesh;
+    const float S = DUCK_SIZE;
+    const float mainSlot = DUCK_SLOT_MAIN;
+    const float bodySlot = DUCK_SLOT_BODY;
+
+    // Beak with the main color
+    addTriangle(mesh,
+        {-S * 0.9f, -S * 0.2f, 0.0f, mainSlot},
+        {-S * 1.2f, 0.0f, 0.0f, mainSlot},
+        {-S * 0.9f, S * 0.2f, 0.0f, mainSlot});
+
+    // Body and neck use the body color
+    float bodyRadius = S * 0.8f;
+    float bodyHeight = S * 0.6f;
+    addEllipse<20>(mesh, 0.0f, 0.0f, bodyRadius * 0.8f, bodyHeight, DUCK_SLOT_BODY);
+
+    DuckVertex neck[] = {
+        {S * 0.5f, -S * 0.1f, 0.0f, bodySlot},
+        {S * 0.7f, -S * 0.1f, 0.0f, bodySlot},
+        {S * 0.7f, S * 0.3f, 0.0f, bodySlot},
+        {S * 0.5f, S * 0.3f, 0.0f, bodySlot},
+    };
+    addPolygon(mesh, neck, 4);
+
+    // Head, bill and eye
+    addEllipse<16>(mesh, S * 0.85f, S * 0.4f, S * 0.3f, S * 0.3f, DUCK_SLOT_MAIN);
+
+    const float billSlot = DUCK_SLOT_ORANGE;
+    addTriangle(mesh,
+        {S * 1.1f, S * 0.3f, 0.0f, billSlot},
+        {S * 1.5f, S * 0.4f, 0.0f, billSlot},
+        {S * 1.1f, S * 0.5f, 0.0f, billSlot});
+
+    addEllipse<12>(mesh, S * 1.0f, S * 0.5f, S * 0.1f, S * 0.1f, DUCK_SLOT_WHITE);
+    addEllipse<8>(mesh, S * 1.0f, S * 0.5f, S * 0.05f, S * 0.05f, DUCK_SLOT_BLACK);
+
+    // Wings, main color. The upper wing tip rises by the full flap, the
+    // lower one drops by 0.8 of it.
+    DuckVertex upperWing[] = {
+        {-S * 0.1f, S * 0.1f, 0.0f, mainSlot},
+        {-S * 0.5f, S * 0.2f, 0.5f, mainSlot},
+        {-S * 0.2f, S * 0.3f, 1.0f, mainSlot},
+        {-S * 0.3f, S * 0.1f, 0.3f, mainSlot},
+        {S * 0.1f, S * 0.1f, 0.0f, mainSlot},
+    };
+    addPolygon(mesh, upperWing, 5);
+
+    DuckVertex lowerWing[] = {
+        {-S * 0.1f, -S * 0.1f, 0.0f, mainSlot},
+        {-S * 0.4f, -S * 0.1f, -0.8f * 0.5f, mainSlot},
+        {-S * 0.2f, -S * 0.1f, -0.8f, mainSlot},
+        {-S * 0.3f, -S * 0.1f, -0.8f * 0.3f, mainSlot},
+        {S * 0.1f, -S * 0.1f, 0.0f, mainSlot},
+    };
+    addPolygon(mesh, lowerWing, 5);
+
+    const float feetSlot = DUCK_SLOT_FEET;
+    addTriangle(mesh,
+        {-S * 0.1f, -S * 0.5f, 0.0f, feetSlot},
+        {-S * 0.3f, -S * 0.7f, 0.0f, feetSlot},
+        {S * 0.1f, -S * 0.7f, 0.0f, feetSlot});
+    addTriangle(mesh,
+        {S * 0.3f, -S * 0.5f, 0.0f, feetSlot},
+        {S * 0.1f, -S * 0.7f, 0.0f, feetSlot},
+        {S * 0.5f, -S * 0.7f, 0.0f, feetSlot});
+
+    return mesh;
+}
+
+const std::vector<DuckVertex>& duckMesh() {
+    static const std::vector<DuckVertex> mesh = buildDuckMesh();
+    return mesh;
+}
+
+static std::vector<DuckVertex> buildImpostorMesh() {
+    std::vector<DuckVertex> mesh;
+    const float S = DUCK_SIZE;
+    const float mainSlot = DUCK_SLOT_MAIN;
+
+    addEllipse<6>(mesh, 0.0f, 0.0f, S * 0.64f, S * 0.6f, DUCK_SLOT_BODY);
+    addEllipse<6>(mesh, S * 0.85f, S * 0.4f, S * 0.3f, S * 0.3f, DUCK_SLOT_MAIN);
+    addTriangle(mesh,
+        {S * 1.1f, S * 0.3f, 0.0f, static_cast<float>(DUCK_SLOT_ORANGE)},
+        {S * 1.5f, S * 0.4f, 0.0f, static_cast<float>(DUCK_SLOT_ORANGE)},
+        {S * 1.1f, S * 0.5f, 0.0f, static_cast<float>(DUCK_SLOT_ORANGE)});
+    addTriangle(mesh,
+        {-S * 0.3f, S * 0.1f, 0.0f, mainSlot},
+        {-S * 0.2f, S * 0.3f, 1.0f, mainSlot},
+        {S * 0.1f, S * 0.1f, 0.0f, mainSlot});
+    return mesh;
+}
+
+const std::vector<DuckVertex>& duckImpostorMesh() {
+    static const std::vector<DuckVertex> mesh = buildImpostorMesh();
+    return mesh;
+}
+
+float duckMeshReach() {
+    // The bill tip is furthest out; a raised wing tip stays inside it
+    return DUCK_SIZE * 1.6f;
+}
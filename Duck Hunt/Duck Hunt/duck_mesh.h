@@ -0,0 +1,43 @@
+#pragma once
+#include <vector>
+
+// Where a mesh vertex takes its colour from. MAIN and BODY come from the
+// duck's palette entry, the others are fixed. FEET vertices are orange and
+// only drawn while the duck is flying level.
+enum DuckColorSlot {
+    DUCK_SLOT_MAIN,
+    DUCK_SLOT_BODY,
+    DUCK_SLOT_ORANGE,
+    DUCK_SLOT_WHITE,
+    DUCK_SLOT_BLACK,
+    DUCK_SLOT_FEET
+};
+
+struct DuckVertex {
+    float x, y;
+    float wing;     // Drawn y is y + wing * wingAngle * 0.7
+    float slot;     // DuckColorSlot
+};
+
+extern const float duckColors[2][3];
+extern const float duckBodyColors[2][3];
+
+// The duck as a triangle list, facing right and centred on the origin. It is
+// built once; the wing flap, facing and palette are applied per instance.
+const std::vector<DuckVertex>& duckMesh();
+
+// Stand-in for ducks too small or too crowded to show detail: a coarse body,
+// head, bill and one wing, about a sixth of duckMesh()'s triangles. Same
+// vertex format and origin, so it takes the same per-instance data.
+const std::vector<DuckVertex>& duckImpostorMesh();
+
+// Radius around a duck's origin that holds either mesh at any wing angle.
+float duckMeshReach();
+
+// Colour of a vertex slot for a duck with the given palette entries.
+const float* duckSlotColor(int slot, int color, int bodyColor);
+
+// Feet are tucked in unless the duck flies mostly horizontally.
+inline bool duckShowsFeet(float dx, float dy) {
+    return (dy < 0 ? -dy : dy) < (dx < 0 ? -dx : dx) * 0.5f;
+}
@@ -0,0 +1,482 @@
+#include "duck_pool.h"
+#include "simulation.h"
+#include <algorithm>
+#include <cmath>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define DUCK_KERNEL_AVX2
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define DUCK_KERNEL_SSE2
+#endif
+
+static const float WING_LIMIT = DUCK_SIZE * 0.8f;
+static const float MIN_HEIGHT = static_cast<float>(WINDOW_HEIGHT / 3.5 + DUCK_SIZE * 2);
+static const float MAX_HEIGHT = static_cast<float>(WINDOW_HEIGHT - DUCK_SIZE);
+static const float MIN_X = -DUCK_SIZE * 2.0f;
+static const float MAX_X = WINDOW_WIDTH + DUCK_SIZE * 2.0f;
+
+static int paddedCount(int count) {
+    return (count + DUCK_LANES - 1) / DUCK_LANES * DUCK_LANES;
+}
+
+static int countBits(int mask) {
+    int bits = 0;
+    while (mask) {
+        mask &= mask - 1;
+        bits++;
+    }
+    return bits;
+}
+
+void reserveDucks(DuckPool& pool, int capacity) {
+    if (capacity <= pool.capacity) {
+        return;
+    }
+
+    size_t size = paddedCount(capacity);
+    pool.x.resize(size, 0.0f);
+    pool.y.resize(size, 0.0f);
+    pool.prevX.resize(size, 0.0f);
+    pool.prevY.resize(size, 0.0f);
+    pool.dx.resize(size, 0.0f);
+    pool.dy.resize(size, 0.0f);
+    pool.wingAngle.resize(size, 0.0f);
+    pool.wingDir.resize(size, 0.0f);
+    pool.alive.resize(size, 0);
+    pool.color.resize(size, 0);
+    pool.bodyColor.resize(size, 0);
+    // Growing changes the row length, so the old rows are dropped
+    pool.historyX.assign(size * DUCK_HISTORY, 0.0f);
+    pool.historyY.assign(size * DUCK_HISTORY, 0.0f);
+    pool.historyDepth.assign(size, 0);
+    std::fill(pool.historyMove, pool.historyMove + DUCK_HISTORY, 0.0f);
+    reserveGrid(pool.grid, static_cast<int>(size));
+    pool.capacity = capacity;
+    countAllocation(pool.stats);
+}
+
+int addDuck(DuckPool& pool, float x, float y, float dx, float dy, int color, int bodyColor) {
+    if (pool.count == pool.capacity) {
+        pool.stats.failedSpawns++;
+        return -1;
+    }
+
+    int i = pool.count;
+    pool.x[i] = x;
+    pool.y[i] = y;
+    pool.prevX[i] = x;
+    pool.prevY[i] = y;
+    pool.dx[i] = dx;
+    pool.dy[i] = dy;
+    pool.wingAngle[i] = DUCK_SIZE * 0.8f;
+    pool.wingDir[i] = -1.0f;
+    pool.alive[i] = 1;
+    pool.color[i] = color;
+    pool.bodyColor[i] = bodyColor;
+    pool.historyDepth[i] = 0;
+    gridInsert(pool.grid, i, gridCell(pool.grid, x, y));
+    pool.count++;
+    countSpawn(pool.stats, pool.count);
+    return i;
+}
+
+#if defined(DUCK_KERNEL_AVX2) || defined(DUCK_KERNEL_SSE2)
+
+// Moves the lanes flagged in changed, starting at duck base, into the cells
+// the kernel computed for them. Ducks rarely cross a cell border, so this
+// runs for a few lanes per tick.
+static void relinkDucks(DuckGrid& grid, int base, int changed, const int* cells) {
+    for (int lane = 0; changed; ++lane, changed >>= 1) {
+        if (changed & 1) {
+            gridRemove(grid, base + lane);
+            gridInsert(grid, base + lane, cells[lane]);
+        }
+    }
+}
+
+#endif
+
+#if defined(DUCK_KERNEL_AVX2)
+
+int updateDucks(DuckPool& pool, float ticks) {
+    const __m256 step = _mm256_set1_ps(ticks);
+    const __m256 wingStep = _mm256_set1_ps(0.2f * ticks);
+    const __m256 wingMax = _mm256_set1_ps(WING_LIMIT);
+    const __m256 wingMin = _mm256_set1_ps(-WING_LIMIT);
+    const __m256 minHeight = _mm256_set1_ps(MIN_HEIGHT);
+    const __m256 maxHeight = _mm256_set1_ps(MAX_HEIGHT);
+    const __m256 minX = _mm256_set1_ps(MIN_X);
+    const __m256 maxX = _mm256_set1_ps(MAX_X);
+    const __m256 signBit = _mm256_set1_ps(-0.0f);
+    const __m256i one = _mm256_set1_epi32(1);
+    const __m256 cellScale = _mm256_set1_ps(pool.grid.cellScale);
+    const __m256 lastColumn = _mm256_set1_ps(static_cast<float>(pool.grid.columns - 1));
+    const __m256 lastRow = _mm256_set1_ps(static_cast<float>(pool.grid.rows - 1));
+    const __m256 columns = _mm256_set1_ps(static_cast<float>(pool.grid.columns));
+    const __m256 zero = _mm256_setzero_ps();
+    alignas(32) int cells[8];
+
+    int alive = 0;
+    int n = paddedCount(pool.count);
+    for (int i = 0; i < n; i += 8) {
+        __m256 x = _mm256_loadu_ps(&pool.x[i]);
+        __m256 y = _mm256_loadu_ps(&pool.y[i]);
+        __m256 dx = _mm256_loadu_ps(&pool.dx[i]);
+        __m256 dy = _mm256_loadu_ps(&pool.dy[i]);
+        __m256 wing = _mm256_loadu_ps(&pool.wingAngle[i]);
+        __m256 wingDir = _mm256_loadu_ps(&pool.wingDir[i]);
+        __m256i live = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&pool.alive[i]));
+
+        x = _mm256_add_ps(x, _mm256_mul_ps(dx, step));
+        y = _mm256_add_ps(y, _mm256_mul_ps(dy, step));
+
+        wing = _mm256_add_ps(wing, _mm256_mul_ps(wingDir, wingStep));
+        __m256 flip = _mm256_or_ps(_mm256_cmp_ps(wing, wingMin, _CMP_LT_OQ),
+                                   _mm256_cmp_ps(wing, wingMax, _CMP_GT_OQ));
+        wingDir = _mm256_xor_ps(wingDir, _mm256_and_ps(flip, signBit));
+
+        // Floor: y = max(y, min), dy = |dy|. Ceiling: y = min(y, max), dy = -|dy|.
+        __m256 absDy = _mm256_andnot_ps(signBit, dy);
+        __m256 below = _mm256_cmp_ps(y, minHeight, _CMP_LT_OQ);
+        dy = _mm256_blendv_ps(dy, absDy, below);
+        y = _mm256_max_ps(y, minHeight);
+        __m256 above = _mm256_cmp_ps(y, maxHeight, _CMP_GT_OQ);
+        dy = _mm256_blendv_ps(dy, _mm256_or_ps(absDy, signBit), above);
+        y = _mm256_min_ps(y, maxHeight);
+
+        __m256 offscreen = _mm256_or_ps(_mm256_cmp_ps(x, minX, _CMP_LT_OQ),
+                                        _mm256_cmp_ps(x, maxX, _CMP_GT_OQ));
+        live = _mm256_andnot_si256(_mm256_castps_si256(offscreen), live);
+        live = _mm256_and_si256(live, one);
+
+        _mm256_storeu_ps(&pool.x[i], x);
+        _mm256_storeu_ps(&pool.y[i], y);
+        _mm256_storeu_ps(&pool.dy[i], dy);
+        _mm256_storeu_ps(&pool.wingAngle[i], wing);
+        _mm256_storeu_ps(&pool.wingDir[i], wingDir);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(&pool.alive[i]), live);
+
+        __m256i liveMask = _mm256_cmpeq_epi32(live, one);
+        alive += countBits(_mm256_movemask_ps(_mm256_castsi256_ps(liveMask)));
+
+        // Grid cell, clamped in float so it matches gridCell()
+        __m256 column = _mm256_min_ps(_mm256_max_ps(_mm256_mul_ps(x, cellScale), zero), lastColumn);
+        __m256 row = _mm256_min_ps(_mm256_max_ps(_mm256_mul_ps(y, cellScale), zero), lastRow);
+        column = _mm256_cvtepi32_ps(_mm256_cvttps_epi32(column));
+        row = _mm256_cvtepi32_ps(_mm256_cvttps_epi32(row));
+        __m256i cell = _mm256_cvtps_epi32(_mm256_add_ps(_mm256_mul_ps(row, columns), column));
+        __m256i oldCell = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&pool.grid.cell[i]));
+        __m256i moved = _mm256_andnot_si256(_mm256_cmpeq_epi32(cell, oldCell), liveMask);
+        int changed = _mm256_movemask_ps(_mm256_castsi256_ps(moved));
+        if (changed) {
+            _mm256_store_si256(reinterpret_cast<__m256i*>(cells), cell);
+            relinkDucks(pool.grid, i, changed, cells);
+        }
+    }
+    return alive;
+}
+
+#elif defined(DUCK_KERNEL_SSE2)
+
+int updateDucks(DuckPool& pool, float ticks) {
+    const __m128 step = _mm_set1_ps(ticks);
+    const __m128 wingStep = _mm_set1_ps(0.2f * ticks);
+    const __m128 wingMax = _mm_set1_ps(WING_LIMIT);
+    const __m128 wingMin = _mm_set1_ps(-WING_LIMIT);
+    const __m128 minHeight = _mm_set1_ps(MIN_HEIGHT);
+    const __m128 maxHeight = _mm_set1_ps(MAX_HEIGHT);
+    const __m128 minX = _mm_set1_ps(MIN_X);
+    const __m128 maxX = _mm_set1_ps(MAX_X);
+    const __m128 signBit = _mm_set1_ps(-0.0f);
+    const __m128i one = _mm_set1_epi32(1);
+    const __m128 cellScale = _mm_set1_ps(pool.grid.cellScale);
+    const __m128 lastColumn = _mm_set1_ps(static_cast<float>(pool.grid.columns - 1));
+    const __m128 lastRow = _mm_set1_ps(static_cast<float>(pool.grid.rows - 1));
+    const __m128 columns = _mm_set1_ps(static_cast<float>(pool.grid.columns));
+    const __m128 zero = _mm_setzero_ps();
+    alignas(16) int cells[4];
+
+    int alive = 0;
+    int n = paddedCount(pool.count);
+    for (int i = 0; i < n; i += 4) {
+        __m128 x = _mm_loadu_ps(&pool.x[i]);
+        __m128 y = _mm_loadu_ps(&pool.y[i]);
+        __m128 dx = _mm_loadu_ps(&pool.dx[i]);
+        __m128 dy = _mm_loadu_ps(&pool.dy[i]);
+        __m128 wing = _mm_loadu_ps(&pool.wingAngle[i]);
+        __m128 wingDir = _mm_loadu_ps(&pool.wingDir[i]);
+        __m128i live = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&pool.alive[i]));
+
+        x = _mm_add_ps(x, _mm_mul_ps(dx, step));
+        y = _mm_add_ps(y, _mm_mul_ps(dy, step));
+
+        wing = _mm_add_ps(wing, _mm_mul_ps(wingDir, wingStep));
+        __m128 flip = _mm_or_ps(_mm_cmplt_ps(wing, wingMin), _mm_cmpgt_ps(wing, wingMax));
+        wingDir = _mm_xor_ps(wingDir, _mm_and_ps(flip, signBit));
+
+        // Floor: y = max(y, min), dy = |dy|. Ceiling: y = min(y, max), dy = -|dy|.
+        // SSE2 has no blendv, so the selects are and/andnot/or.
+        __m128 absDy = _mm_andnot_ps(signBit, dy);
+        __m128 below = _mm_cmplt_ps(y, minHeight);
+        dy = _mm_or_ps(_mm_and_ps(below, absDy), _mm_andnot_ps(below, dy));
+        y = _mm_max_ps(y, minHeight);
+        __m128 above = _mm_cmpgt_ps(y, maxHeight);
+        dy = _mm_or_ps(_mm_and_ps(above, _mm_or_ps(absDy, signBit)), _mm_andnot_ps(above, dy));
+        y = _mm_min_ps(y, maxHeight);
+
+        __m128 offscreen = _mm_or_ps(_mm_cmplt_ps(x, minX), _mm_cmpgt_ps(x, maxX));
+        live = _mm_andnot_si128(_mm_castps_si128(offscreen), live);
+        live = _mm_and_si128(live, one);
+
+        _mm_storeu_ps(&pool.x[i], x);
+        _mm_storeu_ps(&pool.y[i], y);
+        _mm_storeu_ps(&pool.dy[i], dy);
+        _mm_storeu_ps(&pool.wingAngle[i], wing);
+        _mm_storeu_ps(&pool.wingDir[i], wingDir);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(&pool.alive[i]), live);
+
+        __m128i liveMask = _mm_cmpeq_epi32(live, one);
+        alive += countBits(_mm_movemask_ps(_mm_castsi128_ps(liveMask)));
+
+        // Grid cell, clamped in float so it matches gridCell(). SSE2 has no
+        // 32-bit integer multiply, so the row offset is done in float too.
+        __m128 column = _mm_min_ps(_mm_max_ps(_mm_mul_ps(x, cellScale), zero), lastColumn);
+        __m128 row = _mm_min_ps(_mm_max_ps(_mm_mul_ps(y, cellScale), zero), lastRow);
+        column = _mm_cvtepi32_ps(_mm_cvttps_epi32(column));
+        row = _mm_cvtepi32_ps(_mm_cvttps_epi32(row));
+        __m128i cell = _mm_cvtps_epi32(_mm_add_ps(_mm_mul_ps(row, columns), column));
+        __m128i oldCell = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&pool.grid.cell[i]));
+        __m128i moved = _mm_andnot_si128(_mm_cmpeq_epi32(cell, oldCell), liveMask);
+        int changed = _mm_movemask_ps(_mm_castsi128_ps(moved));
+        if (changed) {
+            _mm_store_si128(reinterpret_cast<__m128i*>(cells), cell);
+            relinkDucks(pool.grid, i, changed, cells);
+        }
+    }
+    return alive;
+}
+
+#else
+
+int updateDucks(DuckPool& pool, float ticks) {
+    int alive = 0;
+    for (int i = 0; i < pool.count; ++i) {
+        pool.x[i] += pool.dx[i] * ticks;
+        pool.y[i] += pool.dy[i] * ticks;
+
+        pool.wingAngle[i] += pool.wingDir[i] * 0.2f * ticks;
+        if (pool.wingAngle[i] < -WING_LIMIT || pool.wingAngle[i] > WING_LIMIT) {
+            pool.wingDir[i] *= -1.0f;
+        }
+
+        if (pool.y[i] < MIN_HEIGHT) {
+            pool.y[i] = MIN_HEIGHT;
+            pool.dy[i] = fabs(pool.dy[i]);
+        }
+
+        if (pool.y[i] > MAX_HEIGHT) {
+            pool.y[i] = MAX_HEIGHT;
+            pool.dy[i] = -fabs(pool.dy[i]);
+        }
+
+        if (pool.x[i] < MIN_X || pool.x[i] > MAX_X) {
+            pool.alive[i] = 0;
+        }
+        alive += pool.alive[i];
+
+        int cell = gridCell(pool.grid, pool.x[i], pool.y[i]);
+        if (pool.alive[i] && cell != pool.grid.cell[i]) {
+            gridRemove(pool.grid, i);
+            gridInsert(pool.grid, i, cell);
+        }
+    }
+    return alive;
+}
+
+#endif
+
+void releaseDuck(DuckPool& pool, int i) {
+    int last = --pool.count;
+    gridRemove(pool.grid, i);
+    if (i != last) {
+        gridRenumber(pool.grid, last, i);
+        pool.x[i] = pool.x[last];
+        pool.y[i] = pool.y[last];
+        pool.prevX[i] = pool.prevX[last];
+        pool.prevY[i] = pool.prevY[last];
+        pool.dx[i] = pool.dx[last];
+        pool.dy[i] = pool.dy[last];
+        pool.wingAngle[i] = pool.wingAngle[last];
+        pool.wingDir[i] = pool.wingDir[last];
+        pool.alive[i] = pool.alive[last];
+        pool.color[i] = pool.color[last];
+        pool.bodyColor[i] = pool.bodyColor[last];
+        size_t stride = pool.x.size();
+        for (int row = 0; row < DUCK_HISTORY; ++row) {
+            pool.historyX[row * stride + i] = pool.historyX[row * stride + last];
+            pool.historyY[row * stride + i] = pool.historyY[row * stride + last];
+        }
+        pool.historyDepth[i] = pool.historyDepth[last];
+    }
+
+    // Lanes past the end must read as dead to the kernel
+    pool.alive[last] = 0;
+}
+
+void snapshotDucks(DuckPool& pool) {
+    std::copy(pool.x.begin(), pool.x.begin() + pool.count, pool.prevX.begin());
+    std::copy(pool.y.begin(), pool.y.begin() + pool.count, pool.prevY.begin());
+}
+
+static int historyRow(long long tick) {
+    return static_cast<int>((tick % DUCK_HISTORY + DUCK_HISTORY) % DUCK_HISTORY);
+}
+
+void recordDuckHistory(DuckPool& pool, long long tick) {
+    // Recording the same tick again (a restart between steps) only adds
+    // the ducks spawned since
+    bool newRow = tick != pool.historyTick;
+    float moved = newRow ? 0.0f : pool.historyMove[historyRow(tick)];
+    for (int i = 0; i < pool.count; ++i) {
+        int depth = pool.historyDepth[i];
+        depth = newRow ? depth + 1 : (depth > 1 ? depth : 1);
+        pool.historyDepth[i] = static_cast<unsigned char>(depth < DUCK_HISTORY ? depth : DUCK_HISTORY);
+        // prevX/prevY hold the previous row, or the spawn point
+        moved = std::max(moved, fabsf(pool.x[i] - pool.prevX[i]) + fabsf(pool.y[i] - pool.prevY[i]));
+    }
+    pool.historyMove[historyRow(tick)] = moved;
+    size_t row = historyRow(tick) * pool.x.size();
+    std::copy(pool.x.begin(), pool.x.begin() + pool.count, pool.historyX.begin() + row);
+    std::copy(pool.y.begin(), pool.y.begin() + pool.count, pool.historyY.begin() + row);
+    pool.historyTick = tick;
+}
+
+size_t duckHistoryBytes(const DuckPool& pool) {
+    return (pool.historyX.size() + pool.historyY.size()) * sizeof(float) + pool.historyDepth.size() + sizeof(pool.historyMove);
+}
+
+void releaseDeadDucks(DuckPool& pool) {
+    int i = 0;
+    while (i < pool.count) {
+        if (pool.alive[i]) {
+            i++;
+        }
+        else {
+            releaseDuck(pool, i);
+        }
+    }
+}
+
+void clearDucks(DuckPool& pool) {
+    for (int i = 0; i < pool.count; ++i) {
+        pool.alive[i] = 0;
+    }
+    pool.count = 0;
+    clearGrid(pool.grid);
+}
+
+// Keeps duck i if it is closer than the best so far. A tie goes to the
+// lower index, so the pick does not depend on the order ducks are visited.
+static void keepCloser(int i, float distance, int& best, float& bestDistance) {
+    if (distance < bestDistance || (distance == bestDistance && i < best)) {
+        bestDistance = distance;
+        best = i;
+    }
+}
+
+// Calls visit(i) for every live duck in the grid cells overlapped by the
+// square reaching reach from (x, y) on each side.
+template <typename Visit>
+static void visitDucksNear(const DuckPool& pool, float x, float y, float reach, Visit visit) {
+    const DuckGrid& grid = pool.grid;
+    int firstColumn = gridColumn(grid, x - reach);
+    int lastColumn = gridColumn(grid, x + reach);
+    int firstRow = gridRow(grid, y - reach);
+    int lastRow = gridRow(grid, y + reach);
+    for (int row = firstRow; row <= lastRow; ++row) {
+        for (int column = firstColumn; column <= lastColumn; ++column) {
+            for (int i = grid.head[row * grid.columns + column]; i != -1; i = grid.next[i]) {
+                if (pool.alive[i]) {
+                    visit(i);
+                }
+            }
+        }
+    }
+}
+
+int findDuckAt(const DuckPool& pool, float x, float y, float radius) {
+    int best = -1;
+    float bestDistance = radius * radius;
+    visitDucksNear(pool, x, y, radius, [&](int i) {
+        float dx = pool.x[i] - x;
+        float dy = pool.y[i] - y;
+        keepCloser(i, dx * dx + dy * dy, best, bestDistance);
+    });
+    return best;
+}
+
+int findDuckAtPast(const DuckPool& pool, float x, float y, float radius, float rewind) {
+    if (pool.historyTick < 0) {
+        return findDuckAt(pool, x, y, radius);
+    }
+    const float oldest = static_cast<float>(DUCK_HISTORY - 1);
+    rewind = rewind < 0.0f ? 0.0f : (rewind > oldest ? oldest : rewind);
+    int back = static_cast<int>(rewind);
+    float blend = rewind - static_cast<float>(back);  // Toward the older row
+    size_t stride = pool.x.size();
+    const float* newerX = &pool.historyX[historyRow(pool.historyTick - back) * stride];
+    const float* newerY = &pool.historyY[historyRow(pool.historyTick - back) * stride];
+    const float* olderX = &pool.historyX[historyRow(pool.historyTick - back - 1) * stride];
+    const float* olderY = &pool.historyY[historyRow(pool.historyTick - back - 1) * stride];
+
+    // Every duck now within radius + drift of the shot could have been
+    // within radius of it in the rows tested
+    float drift = 0.0f;
+    for (int i = 0; i <= back; ++i) {
+        drift += pool.historyMove[historyRow(pool.historyTick - i)];
+    }
+
+    int best = -1;
+    float bestDistance = radius * radius;
+    visitDucksNear(pool, x, y, radius + drift, [&](int i) {
+        int depth = pool.historyDepth[i];
+        if (depth <= back) {
+            return;
+        }
+        float px = newerX[i];
+        float py = newerY[i];
+        // A duck spawned in the newer row was drawn standing still there
+        if (blend > 0.0f && depth > back + 1) {
+            px += (olderX[i] - px) * blend;
+            py += (olderY[i] - py) * blend;
+        }
+        float dx = px - x;
+        float dy = py - y;
+        keepCloser(i, dx * dx + dy * dy, best, bestDistance);
+    });
+    return best;
+}
+
+bool predictDuck(const DuckPool& pool, int i, int steps, float ticks, float& x, float& y) {
+    x = pool.x[i];
+    y = pool.y[i];
+    float dy = pool.dy[i];
+    for (int step = 0; step < steps; ++step) {
+        x += pool.dx[i] * ticks;
+        y += dy * ticks;
+        if (y < MIN_HEIGHT) {
+            y = MIN_HEIGHT;
+            dy = fabs(dy);
+        }
+        if (y > MAX_HEIGHT) {
+            y = MAX_HEIGHT;
+            dy = -fabs(dy);
+        }
+        if (x < MIN_X || x > MAX_X) {
+            return false;
+        }
+    }
+    return true;
+}
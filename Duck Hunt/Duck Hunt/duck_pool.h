@@ -0,0 +1,92 @@
+#pragma once
+#include <cstddef>
+#include <vector>
+#include "object_pool.h"
+#include "duck_grid.h"
+
+// Ducks stored as structure-of-arrays so updateDucks() can integrate them
+// several at a time. Every array is padded to a multiple of DUCK_LANES so
+// the kernel never needs a scalar tail; padding lanes are never alive.
+//
+// The pool has a fixed capacity set by reserveDucks(). Live ducks are packed
+// in [0, count) and releaseDuck() swaps the last one into the hole.
+const int DUCK_LANES = 8;
+
+// Ticks of past positions kept for lag-compensated shots, 128 ms at
+// SIM_STEP: a slow frame plus the display's latency.
+const int DUCK_HISTORY = 8;
+
+struct DuckPool {
+    int count = 0;
+    int capacity = 0;
+    PoolStats stats;
+
+    std::vector<float> x, y;
+    std::vector<float> prevX, prevY;  // Position before the last step
+    std::vector<float> dx, dy;
+    std::vector<float> wingAngle;
+    std::vector<float> wingDir;
+    std::vector<int> alive;
+    std::vector<int> color;
+    std::vector<int> bodyColor;
+
+    DuckGrid grid;  // Kept in step by addDuck, updateDucks and releaseDuck
+
+    // Positions at the end of each of the last DUCK_HISTORY ticks, one row
+    // of x.size() per tick, row tick % DUCK_HISTORY. releaseDuck() moves a
+    // duck's column along with the rest of it.
+    std::vector<float> historyX, historyY;
+    std::vector<unsigned char> historyDepth;  // Newest rows that hold duck i
+    long long historyTick = -1;               // Tick of the newest row
+    float historyMove[DUCK_HISTORY] = {};     // Farthest any duck moved into each row, |dx| + |dy|
+};
+
+// Grows the arrays to hold at least capacity ducks. This is the only call
+// that allocates.
+void reserveDucks(DuckPool& pool, int capacity);
+
+// Appends a duck and returns its index, or -1 if the pool is full.
+int addDuck(DuckPool& pool, float x, float y, float dx, float dy, int color, int bodyColor);
+
+// Moves every duck by ticks * (dx, dy), flaps wings, clamps to the floor and
+// ceiling and clears alive for ducks that left the screen, then moves ducks
+// that crossed into another cell of the grid. Returns the number of ducks
+// still alive.
+int updateDucks(DuckPool& pool, float ticks);
+
+// Removes duck i in O(1) by moving the last duck into its slot.
+void releaseDuck(DuckPool& pool, int i);
+
+// Copies the current positions into prevX/prevY. stepWorld() calls this
+// before moving anything so the renderer can blend between the two.
+void snapshotDucks(DuckPool& pool);
+
+// Stores the current positions as the history row of tick. stepWorld()
+// calls this after every step and initWorld() after the first spawns.
+void recordDuckHistory(DuckPool& pool, long long tick);
+
+// Bytes the history takes at the pool's capacity.
+size_t duckHistoryBytes(const DuckPool& pool);
+
+// Releases every duck whose alive flag was cleared.
+void releaseDeadDucks(DuckPool& pool);
+
+void clearDucks(DuckPool& pool);
+
+// Returns the live duck closest to (x, y) within radius, the lowest index
+// on a tie, or -1. Only the grid cells the circle overlaps are searched.
+int findDuckAt(const DuckPool& pool, float x, float y, float radius);
+
+// findDuckAt() against the ducks as they were rewind ticks before the
+// newest history row, blended between rows for a fraction of a tick, the
+// way the renderer interpolates them. A duck only exists from the first
+// row that holds it. rewind is clamped to the history kept. Picks a duck
+// by the same rule as findDuckAt(). The ducks have not moved farther than
+// historyMove adds up to since then, so only the grid cells around the shot
+// grown by that much are searched.
+int findDuckAtPast(const DuckPool& pool, float x, float y, float radius, float rewind);
+
+// Where duck i will be after steps more updateDucks() calls of the given
+// length, floor and ceiling bounces included, if nothing shoots it. Returns
+// false if it leaves the screen first.
+bool predictDuck(const DuckPool& pool, int i, int steps, float ticks, float& x, float& y);
@@ -0,0 +1,217 @@
+#include "duck_renderer.h"
+#include "duck_mesh.h"
+#include "simulation.h"
+#include <vector>
+
+// Below this many pixels of DUCK_SIZE on screen the detail is lost anyway
+const float LOD_MIN_PIXELS = 16.0f;
+// More ducks than this in one grid cell (a shot's reach across) cover each
+// other too much for detail to show
+const int LOD_CROWD = 4;
+
+static const char* duckVertexShader =
+    "#version 120\n"
+    "attribute vec4 vertex;\n"     // x, y, wing weight, color slot
+    "attribute vec4 placement;\n"  // x, y, wing angle, facing
+    "attribute vec3 style;\n"      // color, body color, feet
+    "uniform vec3 mainColors[2];\n"
+    "uniform vec3 bodyColors[2];\n"
+    "varying vec3 color;\n"
+    "void main() {\n"
+    "    float slot = vertex.w;\n"
+    "    vec2 pos = vec2(vertex.x, vertex.y + vertex.z * placement.z * 0.7);\n"
+    "    if (slot > 4.5 && style.z < 0.5) pos = vec2(0.0);\n"  // Feet tucked in
+    "    pos.x *= placement.w;\n"
+    "    if (slot < 0.5) color = mainColors[int(style.x)];\n"
+    "    else if (slot < 1.5) color = bodyColors[int(style.y)];\n"
+    "    else if (slot < 2.5) color = vec3(1.0, 0.5, 0.0);\n"
+    "    else if (slot < 3.5) color = vec3(1.0);\n"
+    "    else if (slot < 4.5) color = vec3(0.0);\n"
+    "    else color = vec3(1.0, 0.5, 0.0);\n"
+    "    gl_Position = gl_ModelViewProjectionMatrix * vec4(pos + placement.xy, 0.0, 1.0);\n"
+    "}\n";
+
+static const char* duckFragmentShader =
+    "#version 120\n"
+    "varying vec3 color;\n"
+    "void main() {\n"
+    "    gl_FragColor = vec4(color, 1.0);\n"
+    "}\n";
+
+static GLuint program = 0;
+static GLuint meshBuffer = 0;
+static GLuint instanceBuffer = 0;
+static std::vector<float> instances;          // Detailed ducks, then impostors
+static std::vector<float> impostorInstances;
+static std::vector<int> cellCounts;
+static DuckDrawStats drawStats;
+
+bool initDuckRenderer(GlProcLoader loader) {
+    if (loader) {
+        loadGlExtensions(loader);
+    }
+    if (!glExt.buffers || !glExt.shaders || !glExt.instancing) {
+        return false;
+    }
+
+    const char* attributes[] = {"vertex", "placement", "style"};
+    program = buildGlProgram(duckVertexShader, duckFragmentShader, attributes, 3);
+    if (!program) {
+        return false;
+    }
+
+    glExt.useProgram(program);
+    glExt.uniform3fv(glExt.getUniformLocation(program, "mainColors"), 2, &duckColors[0][0]);
+    glExt.uniform3fv(glExt.getUniformLocation(program, "bodyColors"), 2, &duckBodyColors[0][0]);
+    glExt.useProgram(0);
+
+    // Both meshes in one buffer, the impostor after the full duck
+    std::vector<DuckVertex> meshes = duckMesh();
+    meshes.insert(meshes.end(), duckImpostorMesh().begin(), duckImpostorMesh().end());
+    glExt.genBuffers(1, &meshBuffer);
+    glExt.bindBuffer(GL_ARRAY_BUFFER, meshBuffer);
+    glExt.bufferData(GL_ARRAY_BUFFER, meshes.size() * sizeof(DuckVertex), meshes.data(), GL_STATIC_DRAW);
+
+    glExt.genBuffers(1, &instanceBuffer);
+    glExt.bindBuffer(GL_ARRAY_BUFFER, 0);
+    return true;
+}
+
+void shutdownDuckRenderer() {
+    if (program) {
+        glExt.deleteProgram(program);
+        glExt.deleteBuffers(1, &meshBuffer);
+        glExt.deleteBuffers(1, &instanceBuffer);
+        program = 0;
+    }
+}
+
+const DuckDrawStats& duckDrawStats() {
+    return drawStats;
+}
+
+static float blend(float from, float to, float alpha) {
+    return from * (1.0f - alpha) + to * alpha;  // Exactly to at alpha 1
+}
+
+// A duck gets the impostor when ducks are drawn too small to show detail,
+// or when its grid cell is so crowded that its neighbours cover most of it.
+void gatherDuckInstances(const DuckPool& ducks, float alpha, int viewportHeight, std::vector<float>& detailed, std::vector<float>& impostors) {
+    drawStats = DuckDrawStats();
+    detailed.clear();
+    impostors.clear();
+    bool small = DUCK_SIZE * viewportHeight < LOD_MIN_PIXELS * WINDOW_HEIGHT;
+
+    const DuckGrid& grid = ducks.grid;
+    cellCounts.assign(grid.head.size(), 0);
+    for (int i = 0; i < ducks.count; ++i) {
+        if (ducks.alive[i]) {
+            cellCounts[grid.cell[i]]++;
+        }
+    }
+
+    float reach = duckMeshReach();
+    for (int i = 0; i < ducks.count; ++i) {
+        if (!ducks.alive[i]) {
+            continue;
+        }
+        float x = blend(ducks.prevX[i], ducks.x[i], alpha);
+        float y = blend(ducks.prevY[i], ducks.y[i], alpha);
+        if (x < -reach || x > WINDOW_WIDTH + reach || y < -reach || y > WINDOW_HEIGHT + reach) {
+            drawStats.culled++;
+            continue;
+        }
+
+        std::vector<float>& out = small || cellCounts[grid.cell[i]] > LOD_CROWD ? impostors : detailed;
+        out.push_back(x);
+        out.push_back(y);
+        out.push_back(ducks.wingAngle[i]);
+        out.push_back(ducks.dx[i] < 0 ? -1.0f : 1.0f);
+        out.push_back(static_cast<float>(ducks.color[i]));
+        out.push_back(static_cast<float>(ducks.bodyColor[i]));
+        out.push_back(duckShowsFeet(ducks.dx[i], ducks.dy[i]) ? 1.0f : 0.0f);
+    }
+    drawStats.detailed = static_cast<int>(detailed.size()) / INSTANCE_FLOATS;
+    drawStats.impostors = static_cast<int>(impostors.size()) / INSTANCE_FLOATS;
+}
+
+static void drawImmediate(const std::vector<DuckVertex>& mesh, const std::vector<float>& data) {
+    for (size_t i = 0; i < data.size(); i += INSTANCE_FLOATS) {
+        const float* duck = &data[i];
+        float wing = duck[2] * 0.7f;
+        float facing = duck[3];
+        int color = static_cast<int>(duck[4]);
+        int bodyColor = static_cast<int>(duck[5]);
+        bool feet = duck[6] > 0.5f;
+
+        glBegin(GL_TRIANGLES);
+        for (const DuckVertex& v : mesh) {
+            if (v.slot == DUCK_SLOT_FEET && !feet) {
+                break;  // Feet are the last triangles in the mesh
+            }
+            glColor3fv(duckSlotColor(static_cast<int>(v.slot), color, bodyColor));
+            glVertex2f(duck[0] + v.x * facing, duck[1] + v.y + v.wing * wing);
+        }
+        glEnd();
+        drawStats.drawCalls++;
+    }
+}
+
+static void pointInstances(int first) {
+    const GLsizei stride = INSTANCE_FLOATS * sizeof(float);
+    const char* base = reinterpret_cast<const char*>(static_cast<size_t>(first) * stride);
+    glExt.vertexAttribPointer(1, 4, GL_FLOAT, GL_FALSE, stride, base);
+    glExt.vertexAttribPointer(2, 3, GL_FLOAT, GL_FALSE, stride, base + 4 * sizeof(float));
+}
+
+void drawDucks(const DuckPool& ducks, float alpha) {
+    GLint viewport[4];
+    glGetIntegerv(GL_VIEWPORT, viewport);
+    gatherDuckInstances(ducks, alpha, viewport[3], instances, impostorInstances);
+    if (!program) {
+        drawImmediate(duckMesh(), instances);
+        drawImmediate(duckImpostorMesh(), impostorInstances);
+        return;
+    }
+
+    int detailed = drawStats.detailed;
+    int impostors = drawStats.impostors;
+    if (detailed + impostors == 0) {
+        return;
+    }
+    instances.insert(instances.end(), impostorInstances.begin(), impostorInstances.end());
+
+    glExt.useProgram(program);
+
+    glExt.bindBuffer(GL_ARRAY_BUFFER, meshBuffer);
+    glExt.enableVertexAttribArray(0);
+    glExt.vertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, sizeof(DuckVertex), nullptr);
+
+    // Orphan and refill the instance buffer every frame
+    glExt.bindBuffer(GL_ARRAY_BUFFER, instanceBuffer);
+    glExt.bufferData(GL_ARRAY_BUFFER, instances.size() * sizeof(float), instances.data(), GL_STREAM_DRAW);
+    glExt.enableVertexAttribArray(1);
+    glExt.vertexAttribDivisor(1, 1);
+    glExt.enableVertexAttribArray(2);
+    glExt.vertexAttribDivisor(2, 1);
+
+    GLsizei meshSize = static_cast<GLsizei>(duckMesh().size());
+    if (detailed > 0) {
+        pointInstances(0);
+        glExt.drawArraysInstanced(GL_TRIANGLES, 0, meshSize, detailed);
+        drawStats.drawCalls++;
+    }
+    if (impostors > 0) {
+        pointInstances(detailed);
+        glExt.drawArraysInstanced(GL_TRIANGLES, meshSize, static_cast<GLsizei>(duckImpostorMesh().size()), impostors);
+        drawStats.drawCalls++;
+    }
+
+    glExt.vertexAttribDivisor(1, 0);
+    glExt.vertexAttribDivisor(2, 0);
+    glExt.disableVertexAttribArray(0);
+    glExt.disableVertexAttribArray(1);
+    glExt.disableVertexAttribArray(2);
+    glExt.bindBuffer(GL_ARRAY_BUFFER, 0);
+    glExt.useProgram(0);
+}
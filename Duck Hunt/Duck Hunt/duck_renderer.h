@@ -0,0 +1,39 @@
+#pragma once
+#include "duck_pool.h"
+#include "gl_ext.h"
+#include <vector>
+
+// Per-duck data: x, y, wing angle, facing (+1/-1), color, body color, feet
+const int INSTANCE_FLOATS = 7;
+
+// Draws the duck pool. With GL 3.3 (or ARB_instanced_arrays) the duck mesh
+// sits in a vertex buffer and every duck goes out in one instanced draw;
+// per-instance data is position, wing angle, facing, palette and feet.
+// Without it each duck is one immediate-mode triangle batch.
+//
+// Needs a current GL context. Returns false when only the fallback is
+// available.
+bool initDuckRenderer(GlProcLoader loader);
+
+// alpha blends each duck between its position before the last step (0) and
+// its current one (1). Ducks entirely off screen are skipped, and ducks
+// drawn very small or in a crowded spot get a low-detail impostor mesh,
+// which goes out as a second instanced draw.
+void drawDucks(const DuckPool& ducks, float alpha = 1.0f);
+void shutdownDuckRenderer();
+
+// The culling and detail choice of drawDucks() without the drawing, for
+// renderers of their own: INSTANCE_FLOATS per duck into detailed and
+// impostors. viewportHeight is the height ducks are drawn at in pixels.
+void gatherDuckInstances(const DuckPool& ducks, float alpha, int viewportHeight,
+    std::vector<float>& detailed, std::vector<float>& impostors);
+
+// What the last drawDucks() did
+struct DuckDrawStats {
+    int drawCalls = 0;
+    int detailed = 0;   // Ducks drawn with the full mesh
+    int impostors = 0;  // Ducks drawn with the impostor
+    int culled = 0;     // Ducks skipped as off screen
+};
+
+const DuckDrawStats& duckDrawStats();
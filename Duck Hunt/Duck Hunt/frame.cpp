@@ -0,0 +1,112 @@
+#include "frame.h"
+#include "background.h"
+#include "duck_renderer.h"
+#include "gl_ext.h"
+#include "hud.h"
+#include "profiler.h"
+#include "shapes.h"
+#include "soft_renderer.h"
+#include "text_renderer.h"
+#include "unit_circle.h"
+#include <cstdio>
+#include <cstring>
+
+static void drawFloatingTexts(const World& world) {
+    glMatrixMode(GL_PROJECTION);
+    glPushMatrix();
+    glLoadIdentity();
+    glOrtho(0, WINDOW_WIDTH, 0, WINDOW_HEIGHT, -1, 1);
+    glMatrixMode(GL_MODELVIEW);
+    glPushMatrix();
+    glLoadIdentity();
+
+    for (int i = 0; i < world.floatingTexts.size(); ++i) {
+        const FloatingText& ft = world.floatingTexts[i];
+        char text[16];
+        snprintf(text, sizeof(text), "+%d", ft.points);
+
+        drawText(TEXT_HELVETICA_12, ft.x, ft.y, 1.0f, 1.0f, 0.0f, ft.alpha, text);
+    }
+
+    glPopMatrix();
+    glMatrixMode(GL_PROJECTION);
+    glPopMatrix();
+    glMatrixMode(GL_MODELVIEW);
+}
+
+void drawScene(const World& world, float alpha) {
+    beginPhase(PHASE_BACKGROUND);
+    drawBackground();
+    endPhase(PHASE_BACKGROUND);
+
+    beginPhase(PHASE_DUCKS);
+    drawDucks(world.ducks, alpha);
+    endPhase(PHASE_DUCKS);
+
+    // Score popups go out in one batch; the HUD flushes its own text into
+    // its cached display list
+    beginPhase(PHASE_FLOATING_TEXT);
+    drawFloatingTexts(world);
+    flushText();
+    endPhase(PHASE_FLOATING_TEXT);
+
+    beginPhase(PHASE_HUD);
+    drawHud(world);
+    endPhase(PHASE_HUD);
+}
+
+void buildCrosshair(int x, int y, ShapeList& list) {
+    beginShape(list, SHAPE_LINES, 1.0f, 0.0f, 0.0f, 2.0f);
+    addPoint(list, x - CROSSHAIR_SIZE, y);
+    addPoint(list, x + CROSSHAIR_SIZE, y);
+    addPoint(list, x, y - CROSSHAIR_SIZE);
+    addPoint(list, x, y + CROSSHAIR_SIZE);
+
+    beginShape(list, SHAPE_LINE_LOOP, 1.0f, 0.0f, 0.0f, 2.0f);
+    float radius = CROSSHAIR_SIZE / 3.0f;
+    for (int i = 0; i < 16; i++) {
+        addPoint(list, x + radius * UnitCircle<16>::cos[i], y + radius * UnitCircle<16>::sin[i]);
+    }
+}
+
+void drawCrosshair(int x, int y) {
+    static ShapeList crosshair;
+    clearShapes(crosshair);
+    buildCrosshair(x, y, crosshair);
+
+    glMatrixMode(GL_PROJECTION);
+    glPushMatrix();
+    glLoadIdentity();
+    glOrtho(0, WINDOW_WIDTH, 0, WINDOW_HEIGHT, -1, 1);
+    glMatrixMode(GL_MODELVIEW);
+    glPushMatrix();
+    glLoadIdentity();
+
+    drawShapes(crosshair);
+
+    glPopMatrix();
+    glMatrixMode(GL_PROJECTION);
+    glPopMatrix();
+    glMatrixMode(GL_MODELVIEW);
+}
+
+static void finishGlFrame() {
+}
+
+static const RenderBackend renderBackends[RENDER_BACKEND_COUNT] = {
+    {"gl", drawScene, drawCrosshair, finishGlFrame},
+    {"soft", softDrawScene, softDrawCrosshair, presentSoftFrame},
+};
+
+const RenderBackend& renderBackend(int backend) {
+    return renderBackends[backend];
+}
+
+int findRenderBackend(const char* name) {
+    for (int backend = 0; backend < RENDER_BACKEND_COUNT; ++backend) {
+        if (strcmp(renderBackends[backend].name, name) == 0) {
+            return backend;
+        }
+    }
+    return -1;
+}
@@ -0,0 +1,39 @@
+#pragma once
+#include "simulation.h"
+#include "shapes.h"
+
+// The game's frame, shared by the window and the offscreen benchmark.
+// Both draw in WINDOW_WIDTH x WINDOW_HEIGHT pixels through their own
+// projection and leave the matrices as they found them.
+
+// Background, ducks interpolated by alpha, score popups and the HUD, each
+// timed as its profiler phase.
+void drawScene(const World& world, float alpha);
+
+// Drawn apart from the scene so the caller can take the freshest pointer
+// position right before it.
+void drawCrosshair(int x, int y);
+
+// The crosshair's lines, for renderers that draw the list themselves.
+void buildCrosshair(int x, int y, ShapeList& list);
+
+enum RenderBackendId {
+    RENDER_GL,
+    RENDER_SOFT,  // soft_renderer.h, put up with one texture upload
+    RENDER_BACKEND_COUNT
+};
+
+// One way of drawing the frame above. The GL backend draws straight into
+// the window; others draw elsewhere and put the result up in finishFrame(),
+// which runs before anything drawn on top in GL, like the profiler overlay.
+struct RenderBackend {
+    const char* name;
+    void (*drawScene)(const World& world, float alpha);
+    void (*drawCrosshair)(int x, int y);
+    void (*finishFrame)();
+};
+
+const RenderBackend& renderBackend(int backend);
+
+// Returns the RenderBackendId called name, or -1.
+int findRenderBackend(const char* name);
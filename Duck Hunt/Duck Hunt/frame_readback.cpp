@@ -0,0 +1,80 @@
+#include "frame_readback.h"
+#include "gl_ext.h"
+#include <cstring>
+#include <vector>
+
+const int READBACK_DEPTH = 3;  // Frames in flight before the oldest is mapped
+
+static int readWidth = 0, readHeight = 0;
+static GLuint packBuffers[READBACK_DEPTH] = {};
+static bool asynchronous = false;
+static std::vector<unsigned char> syncPixels;
+static long long started = 0, taken = 0;
+
+bool initFrameReadback(int width, int height) {
+    readWidth = width;
+    readHeight = height;
+    started = taken = 0;
+    asynchronous = glExt.pixelBuffers;
+    if (!asynchronous) {
+        syncPixels.resize(static_cast<size_t>(width) * height * 4);
+        return false;
+    }
+    glExt.genBuffers(READBACK_DEPTH, packBuffers);
+    for (int i = 0; i < READBACK_DEPTH; ++i) {
+        glExt.bindBuffer(GL_PIXEL_PACK_BUFFER, packBuffers[i]);
+        glExt.bufferData(GL_PIXEL_PACK_BUFFER, static_cast<ptrdiff_t>(width) * height * 4, nullptr, GL_STREAM_READ);
+    }
+    glExt.bindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    return true;
+}
+
+void shutdownFrameReadback() {
+    if (asynchronous) {
+        glExt.deleteBuffers(READBACK_DEPTH, packBuffers);
+        asynchronous = false;
+    }
+    syncPixels.clear();
+}
+
+void readFrame() {
+    glPixelStorei(GL_PACK_ALIGNMENT, 1);
+    if (!asynchronous) {
+        // Only one frame is ever pending: it is taken before the next read
+        glReadPixels(0, 0, readWidth, readHeight, GL_RGBA, GL_UNSIGNED_BYTE, syncPixels.data());
+        started = taken + 1;
+        return;
+    }
+    // A pending frame that was never taken is overwritten
+    if (started - taken == READBACK_DEPTH) {
+        taken++;
+    }
+    glExt.bindBuffer(GL_PIXEL_PACK_BUFFER, packBuffers[started % READBACK_DEPTH]);
+    glReadPixels(0, 0, readWidth, readHeight, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+    glExt.bindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    started++;
+}
+
+bool takeReadFrame(unsigned char* pixels, bool flush) {
+    size_t size = static_cast<size_t>(readWidth) * readHeight * 4;
+    if (!asynchronous) {
+        if (started == taken) {
+            return false;
+        }
+        memcpy(pixels, syncPixels.data(), size);
+        taken = started;
+        return true;
+    }
+    if (started == taken || (!flush && started - taken < READBACK_DEPTH)) {
+        return false;
+    }
+    glExt.bindBuffer(GL_PIXEL_PACK_BUFFER, packBuffers[taken % READBACK_DEPTH]);
+    const void* mapped = glExt.mapBuffer(GL_PIXEL_PACK_BUFFER, GL_READ_ONLY);
+    if (mapped) {
+        memcpy(pixels, mapped, size);
+        glExt.unmapBuffer(GL_PIXEL_PACK_BUFFER);
+    }
+    glExt.bindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    taken++;
+    return mapped != nullptr;
+}
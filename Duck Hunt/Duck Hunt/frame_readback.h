@@ -0,0 +1,22 @@
+#pragma once
+
+// Reads finished frames back from the GL framebuffer without making the
+// drawing thread wait for them. Each readFrame() starts an asynchronous
+// copy into a pixel buffer object, and the copy is only mapped a few
+// frames later, by which time the GPU is long done with it. Where pixel
+// buffers are missing it falls back to a plain glReadPixels.
+//
+// Pixels are RGBA, bottom row first, like softFramebuffer().
+
+// Needs a current context with glExt loaded. Returns false if frames are
+// read synchronously.
+bool initFrameReadback(int width, int height);
+void shutdownFrameReadback();
+
+// Starts reading the framebuffer as it is now.
+void readFrame();
+
+// Copies the oldest frame still pending into pixels (width * height * 4
+// bytes) and returns true, once enough newer frames have been started
+// that it should be ready or, with flush, as long as any is pending.
+bool takeReadFrame(unsigned char* pixels, bool flush);
@@ -0,0 +1,93 @@
+#include "game_loop.h"
+
+int advanceGameLoop(GameLoop& loop, World& world, double now) {
+    if (loop.lastTime < 0.0) {
+        loop.lastTime = now;
+        loop.nextFrame = now;
+        return 0;
+    }
+
+    double frameTime = now - loop.lastTime;
+    loop.lastTime = now;
+    if (frameTime > MAX_FRAME_TIME) {
+        frameTime = MAX_FRAME_TIME;
+    }
+    loop.accumulator += frameTime;
+
+    int steps = 0;
+    while (loop.accumulator >= SIM_STEP) {
+        if (loop.replay) {
+            applyLoggedInput(world, *loop.replay, loop.replayCursor);
+            if (world.tick >= loop.replay->endTick) {
+                loop.accumulator = 0.0;
+                break;
+            }
+        }
+        if (loop.bot) {
+            updateBot(*loop.bot, world, loop.botLog);
+        }
+        stepWorld(world, SIM_STEP);
+        loop.accumulator -= SIM_STEP;
+        steps++;
+    }
+    loop.steps += steps;
+    return steps;
+}
+
+void followSimulation(GameLoop& loop, double stepTime, double now) {
+    // A late tick holds the world where it is rather than run ahead of it
+    double sinceStep = now - stepTime;
+    loop.lastTime = now;
+    loop.accumulator = sinceStep < 0.0 ? 0.0 : sinceStep < SIM_STEP ? sinceStep : SIM_STEP;
+}
+
+float interpolationAlpha(const GameLoop& loop) {
+    return static_cast<float>(loop.accumulator / SIM_STEP);
+}
+
+void requestRedraw(GameLoop& loop) {
+    loop.redrawRequested = true;
+}
+
+// Ducks move between ticks through interpolation and score popups fade,
+// so either one makes every frame different from the last.
+static bool sceneAnimating(const World& world) {
+    bool ducksFlying = !world.gameOver && !world.roundOver && world.ducks.count > 0;
+    return ducksFlying || world.floatingTexts.size() > 0;
+}
+
+bool frameDue(GameLoop& loop, const World& world, double now) {
+    if (!loop.redrawRequested && !sceneAnimating(world)) {
+        loop.skippedPasses++;
+        return false;
+    }
+
+    if (loop.pacing == FRAME_CAPPED) {
+        if (now < loop.nextFrame) {
+            return false;
+        }
+        // Stay on the original cadence unless we fell a whole frame behind
+        loop.nextFrame += loop.frameInterval;
+        if (loop.nextFrame < now) {
+            loop.nextFrame = now + loop.frameInterval;
+        }
+    }
+
+    loop.redrawRequested = false;
+    loop.frames++;
+    return true;
+}
+
+double idleTime(const GameLoop& loop, const World& world, double now) {
+    double untilStep = SIM_STEP - loop.accumulator - (now - loop.lastTime);
+    if (loop.redrawRequested || sceneAnimating(world)) {
+        if (loop.pacing != FRAME_CAPPED) {
+            return 0.0;
+        }
+        double untilFrame = loop.nextFrame - now;
+        if (untilFrame < untilStep) {
+            untilStep = untilFrame;
+        }
+    }
+    return untilStep > 0.0 ? untilStep : 0.0;
+}
@@ -0,0 +1,71 @@
+#pragma once
+#include "simulation.h"
+#include "replay.h"
+#include "bot.h"
+
+// Fixed-step game loop. Real time is fed in from whatever clock the
+// platform has; the world only ever advances in whole SIM_STEP ticks and
+// the leftover fraction is used to interpolate the frame that gets drawn.
+// Rendering is paced separately from the simulation:
+//
+//   FRAME_VSYNC     draw every pass, the buffer swap blocks on the display
+//   FRAME_CAPPED    draw at most once per frameInterval
+//   FRAME_UNCAPPED  draw every pass
+//
+// In every mode a frame is only drawn when something on screen can have
+// changed, so redraw requests from input are coalesced into the next frame.
+enum FramePacing {
+    FRAME_VSYNC,
+    FRAME_CAPPED,
+    FRAME_UNCAPPED
+};
+
+// Longest stretch of real time simulated in one pass. Anything beyond it
+// (a breakpoint, a dragged window) is dropped instead of replayed.
+const double MAX_FRAME_TIME = 0.25;
+
+struct GameLoop {
+    FramePacing pacing = FRAME_VSYNC;
+    double frameInterval = 1.0 / 60.0;  // FRAME_CAPPED only
+
+    double lastTime = -1.0;
+    double accumulator = 0.0;
+    double nextFrame = 0.0;
+    bool redrawRequested = true;
+
+    // When set, the loop feeds this log's events in before each tick and
+    // stops stepping at its endTick
+    const InputLog* replay = nullptr;
+    size_t replayCursor = 0;
+
+    // When set, the bot gets its turn before each tick, with its input
+    // appended to botLog if that is set too
+    Bot* bot = nullptr;
+    InputLog* botLog = nullptr;
+
+    // Counters for the stats line
+    long long steps = 0;
+    long long frames = 0;
+    long long skippedPasses = 0;  // Passes with nothing new to draw
+};
+
+// Runs as many SIM_STEP ticks as the time since the last call allows and
+// returns how many ran. now is in seconds on any monotonic clock.
+int advanceGameLoop(GameLoop& loop, World& world, double now);
+
+// For a loop whose ticks run elsewhere (see sim_thread.h): sets the clock
+// so interpolationAlpha() and idleTime() describe a world whose last tick
+// was due at stepTime. The frame half of the loop works as before.
+void followSimulation(GameLoop& loop, double stepTime, double now);
+
+// How far into the next tick the loop is, in [0, 1).
+float interpolationAlpha(const GameLoop& loop);
+
+// Asks for a frame even if nothing in the world moved (input, resize).
+void requestRedraw(GameLoop& loop);
+
+// Whether a frame should be drawn now. Counts the frame when it returns true.
+bool frameDue(GameLoop& loop, const World& world, double now);
+
+// Seconds the caller can sleep before the next tick or frame is due.
+double idleTime(const GameLoop& loop, const World& world, double now);
@@ -0,0 +1,142 @@
+#include "gl_ext.h"
+#include <cstdio>
+#include <cstring>
+
+GlExtensions glExt;
+
+template <typename T>
+static bool load(GlProcLoader loader, T& function, const char* name) {
+    function = reinterpret_cast<T>(loader(name));
+    return function != nullptr;
+}
+
+static bool hasExtension(const char* name) {
+    const char* extensions = reinterpret_cast<const char*>(glGetString(GL_EXTENSIONS));
+    if (!extensions) {
+        return false;
+    }
+
+    size_t length = strlen(name);
+    for (const char* p = strstr(extensions, name); p; p = strstr(p + length, name)) {
+        if ((p == extensions || p[-1] == ' ') && (p[length] == ' ' || p[length] == '\0')) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void loadGlExtensions(GlProcLoader loader) {
+    // Loaders happily return pointers for functions the driver does not
+    // implement, so the version string decides what is usable.
+    int major = 1, minor = 0;
+    const char* version = reinterpret_cast<const char*>(glGetString(GL_VERSION));
+    if (!version || sscanf(version, "%d.%d", &major, &minor) != 2) {
+        return;
+    }
+    int glVersion = major * 10 + minor;
+
+    if (glVersion >= 15) {
+        glExt.buffers = load(loader, glExt.genBuffers, "glGenBuffers")
+            && load(loader, glExt.deleteBuffers, "glDeleteBuffers")
+            && load(loader, glExt.bindBuffer, "glBindBuffer")
+            && load(loader, glExt.bufferData, "glBufferData");
+    }
+
+    // Pixel pack buffers need nothing beyond mapping on top of 1.5 buffers
+    if (glExt.buffers && (glVersion >= 21 || hasExtension("GL_ARB_pixel_buffer_object"))) {
+        glExt.pixelBuffers = load(loader, glExt.mapBuffer, "glMapBuffer")
+            && load(loader, glExt.unmapBuffer, "glUnmapBuffer");
+    }
+
+    if (glVersion >= 20) {
+        glExt.shaders = load(loader, glExt.createShader, "glCreateShader")
+            && load(loader, glExt.deleteShader, "glDeleteShader")
+            && load(loader, glExt.shaderSource, "glShaderSource")
+            && load(loader, glExt.compileShader, "glCompileShader")
+            && load(loader, glExt.getShaderiv, "glGetShaderiv")
+            && load(loader, glExt.getShaderInfoLog, "glGetShaderInfoLog")
+            && load(loader, glExt.createProgram, "glCreateProgram")
+            && load(loader, glExt.deleteProgram, "glDeleteProgram")
+            && load(loader, glExt.attachShader, "glAttachShader")
+            && load(loader, glExt.bindAttribLocation, "glBindAttribLocation")
+            && load(loader, glExt.linkProgram, "glLinkProgram")
+            && load(loader, glExt.getProgramiv, "glGetProgramiv")
+            && load(loader, glExt.getProgramInfoLog, "glGetProgramInfoLog")
+            && load(loader, glExt.useProgram, "glUseProgram")
+            && load(loader, glExt.getUniformLocation, "glGetUniformLocation")
+            && load(loader, glExt.uniform3fv, "glUniform3fv")
+            && load(loader, glExt.enableVertexAttribArray, "glEnableVertexAttribArray")
+            && load(loader, glExt.disableVertexAttribArray, "glDisableVertexAttribArray")
+            && load(loader, glExt.vertexAttribPointer, "glVertexAttribPointer");
+    }
+
+    if (glVersion >= 33) {
+        glExt.instancing = load(loader, glExt.vertexAttribDivisor, "glVertexAttribDivisor")
+            && load(loader, glExt.drawArraysInstanced, "glDrawArraysInstanced");
+    }
+    else if (hasExtension("GL_ARB_instanced_arrays") && hasExtension("GL_ARB_draw_instanced")) {
+        glExt.instancing = load(loader, glExt.vertexAttribDivisor, "glVertexAttribDivisorARB")
+            && load(loader, glExt.drawArraysInstanced, "glDrawArraysInstancedARB");
+    }
+
+    // ARB_timer_query keeps the core names
+    if (glVersion >= 33 || hasExtension("GL_ARB_timer_query")) {
+        glExt.timerQueries = load(loader, glExt.genQueries, "glGenQueries")
+            && load(loader, glExt.deleteQueries, "glDeleteQueries")
+            && load(loader, glExt.queryCounter, "glQueryCounter")
+            && load(loader, glExt.getQueryObjectiv, "glGetQueryObjectiv")
+            && load(loader, glExt.getQueryObjectui64v, "glGetQueryObjectui64v");
+    }
+}
+
+static GLuint compileShader(GLenum type, const char* source) {
+    GLuint shader = glExt.createShader(type);
+    glExt.shaderSource(shader, 1, &source, nullptr);
+    glExt.compileShader(shader);
+
+    GLint ok = 0;
+    glExt.getShaderiv(shader, GL_COMPILE_STATUS, &ok);
+    if (!ok) {
+        char log[1024];
+        glExt.getShaderInfoLog(shader, sizeof(log), nullptr, log);
+        fprintf(stderr, "Shader compile failed: %s\n", log);
+        glExt.deleteShader(shader);
+        return 0;
+    }
+    return shader;
+}
+
+GLuint buildGlProgram(const char* vertexSource, const char* fragmentSource, const char* const* attributes, int attributeCount) {
+    if (!glExt.shaders) {
+        return 0;
+    }
+
+    GLuint vertexShader = compileShader(GL_VERTEX_SHADER, vertexSource);
+    GLuint fragmentShader = compileShader(GL_FRAGMENT_SHADER, fragmentSource);
+    if (!vertexShader || !fragmentShader) {
+        if (vertexShader) glExt.deleteShader(vertexShader);
+        if (fragmentShader) glExt.deleteShader(fragmentShader);
+        return 0;
+    }
+
+    GLuint program = glExt.createProgram();
+    glExt.attachShader(program, vertexShader);
+    glExt.attachShader(program, fragmentShader);
+    for (int i = 0; i < attributeCount; ++i) {
+        glExt.bindAttribLocation(program, i, attributes[i]);
+    }
+    glExt.linkProgram(program);
+    glExt.deleteShader(vertexShader);
+    glExt.deleteShader(fragmentShader);
+
+    GLint ok = 0;
+    glExt.getProgramiv(program, GL_LINK_STATUS, &ok);
+    if (!ok) {
+        char log[1024];
+        glExt.getProgramInfoLog(program, sizeof(log), nullptr, log);
+        fprintf(stderr, "Shader link failed: %s\n", log);
+        glExt.deleteProgram(program);
+        return 0;
+    }
+    return program;
+}
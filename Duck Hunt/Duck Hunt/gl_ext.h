@@ -0,0 +1,111 @@
+#pragma once
+#ifdef _WIN32
+#include <windows.h>
+#endif
+#include <GL/gl.h>
+#include <cstddef>
+
+// The few post-1.1 entry points the renderers use. The Windows SDK only
+// ships GL 1.1 headers, so the constants and signatures are spelled out
+// here instead of coming from glext.h.
+#ifndef APIENTRY
+#define APIENTRY
+#endif
+
+#ifndef GL_ARRAY_BUFFER
+#define GL_ARRAY_BUFFER 0x8892
+#endif
+#ifndef GL_STREAM_DRAW
+#define GL_STREAM_DRAW 0x88E0
+#endif
+#ifndef GL_PIXEL_PACK_BUFFER
+#define GL_PIXEL_PACK_BUFFER 0x88EB
+#endif
+#ifndef GL_STREAM_READ
+#define GL_STREAM_READ 0x88E1
+#endif
+#ifndef GL_READ_ONLY
+#define GL_READ_ONLY 0x88B8
+#endif
+#ifndef GL_STATIC_DRAW
+#define GL_STATIC_DRAW 0x88E4
+#endif
+#ifndef GL_FRAGMENT_SHADER
+#define GL_FRAGMENT_SHADER 0x8B30
+#endif
+#ifndef GL_VERTEX_SHADER
+#define GL_VERTEX_SHADER 0x8B31
+#endif
+#ifndef GL_COMPILE_STATUS
+#define GL_COMPILE_STATUS 0x8B81
+#endif
+#ifndef GL_LINK_STATUS
+#define GL_LINK_STATUS 0x8B82
+#endif
+#ifndef GL_QUERY_RESULT
+#define GL_QUERY_RESULT 0x8866
+#endif
+#ifndef GL_QUERY_RESULT_AVAILABLE
+#define GL_QUERY_RESULT_AVAILABLE 0x8867
+#endif
+#ifndef GL_TIMESTAMP
+#define GL_TIMESTAMP 0x8E28
+#endif
+
+typedef void (*GlProc)();
+typedef GlProc (*GlProcLoader)(const char* name);
+
+struct GlExtensions {
+    bool buffers = false;       // GL 1.5 vertex buffer objects
+    bool shaders = false;       // GL 2.0 GLSL programs
+    bool instancing = false;    // GL 3.3 / ARB_instanced_arrays
+    bool timerQueries = false;  // GL 3.3 / ARB_timer_query
+    bool pixelBuffers = false;  // GL 2.1 / ARB_pixel_buffer_object
+
+    void (APIENTRY* genBuffers)(GLsizei n, GLuint* buffers);
+    void (APIENTRY* deleteBuffers)(GLsizei n, const GLuint* buffers);
+    void (APIENTRY* bindBuffer)(GLenum target, GLuint buffer);
+    void (APIENTRY* bufferData)(GLenum target, ptrdiff_t size, const void* data, GLenum usage);
+    void* (APIENTRY* mapBuffer)(GLenum target, GLenum access);
+    GLboolean (APIENTRY* unmapBuffer)(GLenum target);
+
+    GLuint (APIENTRY* createShader)(GLenum type);
+    void (APIENTRY* deleteShader)(GLuint shader);
+    void (APIENTRY* shaderSource)(GLuint shader, GLsizei count, const char* const* source, const GLint* length);
+    void (APIENTRY* compileShader)(GLuint shader);
+    void (APIENTRY* getShaderiv)(GLuint shader, GLenum name, GLint* value);
+    void (APIENTRY* getShaderInfoLog)(GLuint shader, GLsizei size, GLsizei* length, char* log);
+    GLuint (APIENTRY* createProgram)();
+    void (APIENTRY* deleteProgram)(GLuint program);
+    void (APIENTRY* attachShader)(GLuint program, GLuint shader);
+    void (APIENTRY* bindAttribLocation)(GLuint program, GLuint index, const char* name);
+    void (APIENTRY* linkProgram)(GLuint program);
+    void (APIENTRY* getProgramiv)(GLuint program, GLenum name, GLint* value);
+    void (APIENTRY* getProgramInfoLog)(GLuint program, GLsizei size, GLsizei* length, char* log);
+    void (APIENTRY* useProgram)(GLuint program);
+    GLint (APIENTRY* getUniformLocation)(GLuint program, const char* name);
+    void (APIENTRY* uniform3fv)(GLint location, GLsizei count, const GLfloat* value);
+    void (APIENTRY* enableVertexAttribArray)(GLuint index);
+    void (APIENTRY* disableVertexAttribArray)(GLuint index);
+    void (APIENTRY* vertexAttribPointer)(GLuint index, GLint size, GLenum type, GLboolean normalized, GLsizei stride, const void* pointer);
+
+    void (APIENTRY* vertexAttribDivisor)(GLuint index, GLuint divisor);
+    void (APIENTRY* drawArraysInstanced)(GLenum mode, GLint first, GLsizei count, GLsizei instances);
+
+    void (APIENTRY* genQueries)(GLsizei n, GLuint* ids);
+    void (APIENTRY* deleteQueries)(GLsizei n, const GLuint* ids);
+    void (APIENTRY* queryCounter)(GLuint id, GLenum target);
+    void (APIENTRY* getQueryObjectiv)(GLuint id, GLenum name, GLint* value);
+    void (APIENTRY* getQueryObjectui64v)(GLuint id, GLenum name, unsigned long long* value);
+};
+
+extern GlExtensions glExt;
+
+// Resolves everything in glExt through the windowing layer's loader
+// (wglGetProcAddress, glutGetProcAddress, eglGetProcAddress). Needs a
+// current context. Missing groups are left flagged false.
+void loadGlExtensions(GlProcLoader loader);
+
+// Compiles and links a program; returns 0 and prints the log on failure.
+// Attribute names are bound to locations 0, 1, 2... in order.
+GLuint buildGlProgram(const char* vertexSource, const char* fragmentSource, const char* const* attributes, int attributeCount);
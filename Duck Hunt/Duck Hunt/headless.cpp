@@ -0,0 +1,217 @@
+// Runs the simulation without a window, for benchmarking and regression
+// checks on machines with no display or GPU.
+//
+//   duckhunt_headless [--ticks N] [--shoot-every N] [--seed N] [--ducks N]
+//                     [--spawn-rate N] [--mode classic|swarm|sniper|stress]
+//                     [--record PATH] [--replay PATH]
+//                     [--bot] [--reaction TICKS] [--cooldown TICKS]
+//                     [--telemetry PATH]
+//
+// The scripted shooter fires at the duck in slot 0 of the pool every
+// --shoot-every ticks. Releases swap ducks around, so that is not always
+// the oldest one.
+// --bot plays with the predictive bot instead (see bot.h).
+//
+// --record saves the scripted shooter's input as a replay log. --replay runs
+// a log (from here or from the game) at full speed instead of the shooter,
+// and exits with status 1 if the final state differs from the recording.
+//
+// --telemetry streams gameplay events to PATH.0.dhtl.gz and onwards (see
+// telemetry.h). Running flat out, the writer can fall behind; what it
+// misses is counted as dropped.
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include "simulation.h"
+#include "replay.h"
+#include "bot.h"
+#include "telemetry.h"
+
+struct Tally {
+    long long games = 0;
+    long long hits = 0;
+    long long shots = 0;
+    bool over = false;  // The last game counted has not restarted yet
+};
+
+// Counts a game once it is over, whoever restarts it. Call after anything
+// that can end or restart a game.
+static void countGameEnd(Tally& tally, const World& world) {
+    bool over = world.gameOver || world.roundOver;
+    if (over && !tally.over) {
+        tally.games++;
+        tally.hits += world.totalShots - world.missedShots;
+        tally.shots += world.totalShots;
+    }
+    tally.over = over;
+}
+
+static void replayInput(World& world, Tally& tally, const InputLog& log, size_t& cursor) {
+    while (cursor < log.events.size() && log.events[cursor].tick <= world.tick) {
+        applyInput(world, log.events[cursor]);
+        countGameEnd(tally, world);
+        cursor++;
+    }
+}
+
+int main(int argc, char** argv) {
+    long long ticks = 10000000;
+    int shootEvery = 30;
+    uint64_t seed = 1;
+    int maxDucks = 0;
+    int spawnsPerTick = 0;
+    int mode = MODE_CLASSIC;
+    const char* recordPath = nullptr;
+    const char* replayPath = nullptr;
+    bool useBot = false;
+    Bot bot;
+    const char* telemetryPath = nullptr;
+
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "--ticks") == 0 && i + 1 < argc) {
+            ticks = atoll(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--shoot-every") == 0 && i + 1 < argc) {
+            shootEvery = atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc) {
+            seed = strtoull(argv[++i], nullptr, 10);
+        }
+        else if (strcmp(argv[i], "--ducks") == 0 && i + 1 < argc) {
+            maxDucks = atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--spawn-rate") == 0 && i + 1 < argc) {
+            spawnsPerTick = atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--mode") == 0 && i + 1 < argc && findGameMode(argv[i + 1]) != -1) {
+            mode = findGameMode(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--record") == 0 && i + 1 < argc) {
+            recordPath = argv[++i];
+        }
+        else if (strcmp(argv[i], "--replay") == 0 && i + 1 < argc) {
+            replayPath = argv[++i];
+        }
+        else if (strcmp(argv[i], "--bot") == 0) {
+            useBot = true;
+        }
+        else if (strcmp(argv[i], "--reaction") == 0 && i + 1 < argc) {
+            bot.config.reactionTicks = atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--cooldown") == 0 && i + 1 < argc) {
+            bot.config.cooldownTicks = atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--telemetry") == 0 && i + 1 < argc) {
+            telemetryPath = argv[++i];
+        }
+        else {
+            fprintf(stderr, "usage: %s [--ticks N] [--shoot-every N] [--seed N] [--ducks N] [--spawn-rate N] [--mode classic|swarm|sniper|stress] [--record PATH] [--replay PATH] [--bot] [--reaction TICKS] [--cooldown TICKS] [--telemetry PATH]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    InputLog log;
+    World world;
+    static Telemetry telemetry;
+    if (telemetryPath) {
+        TelemetryConfig config;
+        config.path = telemetryPath;
+        if (!startTelemetry(telemetry, config)) {
+            return 2;
+        }
+        world.telemetry = &telemetry;
+    }
+    if (replayPath) {
+        if (!readInputLog(replayPath, log)) {
+            fprintf(stderr, "cannot read replay log %s\n", replayPath);
+            return 2;
+        }
+        ticks = log.endTick;
+        startFromLog(world, log);
+    }
+    else {
+        log.seed = seed;
+        log.mode = mode;
+        log.maxDucks = maxDucks;
+        log.spawnsPerTick = spawnsPerTick;
+        startFromLog(world, log);
+    }
+
+    Tally tally;
+    size_t cursor = 0;
+    long long steadyAllocations = 0;
+
+    auto start = std::chrono::steady_clock::now();
+    for (long long tick = 0; tick < ticks; ++tick) {
+        if (replayPath) {
+            replayInput(world, tally, log, cursor);
+        }
+        else if (useBot) {
+            updateBot(bot, world, recordPath ? &log : nullptr);
+            countGameEnd(tally, world);
+        }
+
+        stepWorld(world, SIM_STEP);
+        steadyAllocations += world.ducks.stats.frameAllocations + world.floatingTexts.stats.frameAllocations;
+        countGameEnd(tally, world);
+
+        // Scripted shooter: aim at the duck in slot 0 on a fixed cadence
+        if (!replayPath && !useBot && shootEvery > 0 && tick % shootEvery == 0) {
+            int x = 0, y = 0;
+            if (!world.gameOver && !world.roundOver) {
+                if (world.ducks.count == 0) {
+                    continue;
+                }
+                x = static_cast<int>(world.ducks.x[0] + 0.5f);
+                y = static_cast<int>(world.ducks.y[0] + 0.5f);
+            }
+            submitInput(world, recordPath ? &log : nullptr, INPUT_SHOT, x, y);
+            countGameEnd(tally, world);
+        }
+    }
+    if (replayPath) {
+        // Input that came in after the last step of the recording
+        replayInput(world, tally, log, cursor);
+    }
+    auto end = std::chrono::steady_clock::now();
+    stopTelemetry(telemetry);
+
+    double seconds = std::chrono::duration<double>(end - start).count();
+    printf("mode:         %s\n", gameMode(world.mode).name);
+    printf("ticks:        %lld\n", ticks);
+    printf("elapsed:      %.3f s\n", seconds);
+    printf("ticks/sec:    %.0f\n", seconds > 0.0 ? ticks / seconds : 0.0);
+    printf("games:        %lld\n", tally.games);
+    printf("accuracy:     %.3f\n", tally.shots > 0 ? static_cast<double>(tally.hits) / tally.shots : 0.0);
+    printf("final score:  %d\n", world.score);
+    printf("duck pool:    high water %d/%d, %d spawns, %d refused\n",
+        world.ducks.stats.highWater, world.ducks.capacity,
+        world.ducks.stats.spawns, world.ducks.stats.failedSpawns);
+    printf("text pool:    high water %d/%d, %d spawns, %d refused\n",
+        world.floatingTexts.stats.highWater, world.floatingTexts.capacity(),
+        world.floatingTexts.stats.spawns, world.floatingTexts.stats.failedSpawns);
+    printf("allocations:  %d at startup, %lld while running\n",
+        world.ducks.stats.allocations + world.floatingTexts.stats.allocations, steadyAllocations);
+    printf("checksum:     %08x\n", worldChecksum(world));
+    if (telemetryPath) {
+        TelemetryStats stats = telemetryStats(telemetry);
+        printf("telemetry:    %lld events, %lld dropped, %lld written to %d files%s\n",
+            stats.recorded, stats.dropped, stats.written, stats.files, stats.failed ? " (write failed)" : "");
+    }
+
+    if (recordPath) {
+        finishRecording(log, world);
+        if (!writeInputLog(recordPath, log)) {
+            fprintf(stderr, "cannot write replay log %s\n", recordPath);
+            return 2;
+        }
+        printf("recorded:     %zu events to %s\n", log.events.size(), recordPath);
+    }
+    if (replayPath) {
+        bool match = worldChecksum(world) == log.checksum;
+        printf("replay:       %s (recorded %08x)\n", match ? "match" : "MISMATCH", log.checksum);
+        return match ? 0 : 1;
+    }
+    return 0;
+}
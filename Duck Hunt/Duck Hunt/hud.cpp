@@ -0,0 +1,154 @@
+#include "hud.h"
+#include "gl_ext.h"
+#include "shapes.h"
+#include "text_renderer.h"
+#include <cstdio>
+
+static void buildHud(const World& world, ShapeList& list) {
+    beginShape(list, SHAPE_QUADS, 0.6f, 0.3f, 0.1f);
+    addPoint(list, 0, 0);
+    addPoint(list, WINDOW_WIDTH, 0);
+    addPoint(list, WINDOW_WIDTH, WINDOW_HEIGHT / 10);
+    addPoint(list, 0, WINDOW_HEIGHT / 10);
+
+    beginShape(list, SHAPE_QUADS, 0.0f, 0.0f, 0.0f);
+    addPoint(list, 10, WINDOW_HEIGHT / 60);
+    addPoint(list, 120, WINDOW_HEIGHT / 60);
+    addPoint(list, 120, WINDOW_HEIGHT * 0.09);
+    addPoint(list, 10, WINDOW_HEIGHT * 0.09);
+
+    addShapeText(list, TEXT_HELVETICA_12, 15, WINDOW_HEIGHT / 20, 1.0f, 0.6f, 0.0f, "SHOT");
+
+    for (int i = 0; i < 3 - world.missedShots % 3; i++) {
+        beginShape(list, SHAPE_QUADS, 0.7f, 0.5f, 0.1f);
+        addPoint(list, 55 + i * 20, WINDOW_HEIGHT / 40);
+        addPoint(list, 70 + i * 20, WINDOW_HEIGHT / 40);
+        addPoint(list, 70 + i * 20, WINDOW_HEIGHT / 18);
+        addPoint(list, 55 + i * 20, WINDOW_HEIGHT / 18);
+
+        beginShape(list, SHAPE_QUADS, 0.0f, 0.5f, 1.0f);
+        addPoint(list, 55 + i * 20, WINDOW_HEIGHT / 18);
+        addPoint(list, 70 + i * 20, WINDOW_HEIGHT / 18);
+        addPoint(list, 70 + i * 20, WINDOW_HEIGHT / 13);
+        addPoint(list, 55 + i * 20, WINDOW_HEIGHT / 13);
+    }
+
+    beginShape(list, SHAPE_QUADS, 0.0f, 0.0f, 0.0f);
+    addPoint(list, 130, WINDOW_HEIGHT / 60);
+    addPoint(list, WINDOW_WIDTH - 160, WINDOW_HEIGHT / 60);
+    addPoint(list, WINDOW_WIDTH - 160, WINDOW_HEIGHT * 0.09);
+    addPoint(list, 130, WINDOW_HEIGHT * 0.09);
+
+    addShapeText(list, TEXT_HELVETICA_12, 140, WINDOW_HEIGHT / 20, 1.0f, 0.9f, 0.0f, "HIT");
+
+    int hitMarkWidth = (WINDOW_WIDTH - 350) / 10;
+    for (int i = 0; i < world.score % 10; i++) {
+        beginShape(list, SHAPE_LINE_STRIP, 1.0f, 1.0f, 1.0f, 2.0f);
+        addPoint(list, 180 + i * hitMarkWidth, WINDOW_HEIGHT / 45);
+        addPoint(list, 180 + i * hitMarkWidth + hitMarkWidth / 2, WINDOW_HEIGHT / 15);
+        addPoint(list, 180 + i * hitMarkWidth + hitMarkWidth, WINDOW_HEIGHT / 45);
+    }
+
+    // New score display similar to image
+    beginShape(list, SHAPE_QUADS, 0.0f, 0.0f, 0.0f);
+    addPoint(list, WINDOW_WIDTH - 150, WINDOW_HEIGHT / 60);
+    addPoint(list, WINDOW_WIDTH - 10, WINDOW_HEIGHT / 60);
+    addPoint(list, WINDOW_WIDTH - 10, WINDOW_HEIGHT * 0.09);
+    addPoint(list, WINDOW_WIDTH - 150, WINDOW_HEIGHT * 0.09);
+
+    // Dark green background for score display
+    beginShape(list, SHAPE_QUADS, 0.0f, 0.2f, 0.0f);
+    addPoint(list, WINDOW_WIDTH - 145, WINDOW_HEIGHT / 40);
+    addPoint(list, WINDOW_WIDTH - 15, WINDOW_HEIGHT / 40);
+    addPoint(list, WINDOW_WIDTH - 15, WINDOW_HEIGHT * 0.08);
+    addPoint(list, WINDOW_WIDTH - 145, WINDOW_HEIGHT * 0.08);
+
+    // Score text, padded with leading zeros
+    char scoreStr[16];
+    snprintf(scoreStr, sizeof(scoreStr), "%06d", world.score);
+
+    // Yellow/gold color for score
+    addShapeText(list, TEXT_HELVETICA_12, WINDOW_WIDTH - 140, WINDOW_HEIGHT / 20, 0.8f, 0.8f, 0.0f, "SCORE");
+
+    // Display score digits
+    addShapeText(list, TEXT_FIXED_9_BY_15, WINDOW_WIDTH - 95, WINDOW_HEIGHT / 20, 0.8f, 0.8f, 0.0f, scoreStr);
+
+    // Add shots remaining display
+    char shotsText[32];
+    snprintf(shotsText, sizeof(shotsText), "SHOTS: %d/%d", world.shotsRemaining, gameMode(world.mode).shotsPerRound);
+    addShapeText(list, TEXT_HELVETICA_12, 15, WINDOW_HEIGHT / 20 + 20, 1.0f, 1.0f, 1.0f, shotsText);
+
+    if (world.gameOver || world.roundOver) {
+        const char* endMessage = world.gameOver ? "GAME OVER!" : "ROUND OVER!";
+        char finalScore[32];
+        snprintf(finalScore, sizeof(finalScore), "Final Score: %d", world.score);
+
+        addShapeText(list, TEXT_HELVETICA_18, WINDOW_WIDTH / 2 - 100, WINDOW_HEIGHT / 2, 1.0f, 0.0f, 0.0f, endMessage);
+        addShapeText(list, TEXT_HELVETICA_18, WINDOW_WIDTH / 2 - 60, WINDOW_HEIGHT / 2 - 30, 1.0f, 0.0f, 0.0f, finalScore);
+        addShapeText(list, TEXT_HELVETICA_18, WINDOW_WIDTH / 2 - 60, WINDOW_HEIGHT / 2 - 60, 1.0f, 0.0f, 0.0f, "Click to Restart");
+    }
+}
+
+static ShapeList shapes;
+static unsigned int shapesVersion = 0;
+static bool shapesValid = false;
+
+static GLuint hudList = 0;
+static unsigned int hudVersion = 0;
+static bool hudValid = false;
+static HudCacheStats stats = {0, 0};
+
+void drawHud(const World& world) {
+    if (hudValid && world.hudVersion == hudVersion) {
+        stats.reusedFrames++;
+        glCallList(hudList);
+        return;
+    }
+
+    if (!hudList) {
+        hudList = glGenLists(1);
+    }
+
+    // The HUD text is flushed inside the list; glDrawArrays copies the
+    // client arrays at compile time.
+    glNewList(hudList, GL_COMPILE);
+    glMatrixMode(GL_PROJECTION);
+    glPushMatrix();
+    glLoadIdentity();
+    glOrtho(0, WINDOW_WIDTH, 0, WINDOW_HEIGHT, -1, 1);
+    glMatrixMode(GL_MODELVIEW);
+    glPushMatrix();
+    glLoadIdentity();
+
+    drawShapes(hudShapes(world));
+
+    glPopMatrix();
+    glMatrixMode(GL_PROJECTION);
+    glPopMatrix();
+    glMatrixMode(GL_MODELVIEW);
+    glEndList();
+
+    hudVersion = world.hudVersion;
+    hudValid = true;
+    stats.rebuilds++;
+    glCallList(hudList);
+}
+
+void invalidateHud() {
+    hudValid = false;
+    shapesValid = false;
+}
+
+const ShapeList& hudShapes(const World& world) {
+    if (!shapesValid || world.hudVersion != shapesVersion) {
+        clearShapes(shapes);
+        buildHud(world, shapes);
+        shapesVersion = world.hudVersion;
+        shapesValid = true;
+    }
+    return shapes;
+}
+
+HudCacheStats hudCacheStats() {
+    return stats;
+}
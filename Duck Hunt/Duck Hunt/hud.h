@@ -0,0 +1,22 @@
+#pragma once
+#include "simulation.h"
+#include "shapes.h"
+
+// Draws the score bar and the end of game messages. The HUD only depends on
+// the fields counted by World::hudVersion, so it is compiled into a display
+// list and replayed until that version moves.
+void drawHud(const World& world);
+
+// Forces a rebuild on the next drawHud(), e.g. after swapping in another World.
+void invalidateHud();
+
+// The HUD as geometry and text, rebuilt only when World::hudVersion moves.
+// drawHud() compiles its display list from it.
+const ShapeList& hudShapes(const World& world);
+
+struct HudCacheStats {
+    int rebuilds;
+    int reusedFrames;
+};
+
+HudCacheStats hudCacheStats();
@@ -0,0 +1,73 @@
+#pragma once
+#include <vector>
+
+// Counters shared by the fixed-capacity pools. A pool only touches the heap
+// in reserve(), so once the game is running frameAllocations should stay 0.
+struct PoolStats {
+    int highWater = 0;          // Most objects live at once
+    int spawns = 0;             // Successful spawns since start
+    int failedSpawns = 0;       // Spawns refused because the pool was full
+    int allocations = 0;        // Heap allocations since start
+    int frameSpawns = 0;        // Spawns since beginPoolFrame()
+    int frameAllocations = 0;   // Heap allocations since beginPoolFrame()
+};
+
+inline void beginPoolFrame(PoolStats& stats) {
+    stats.frameSpawns = 0;
+    stats.frameAllocations = 0;
+}
+
+inline void countSpawn(PoolStats& stats, int liveCount) {
+    stats.spawns++;
+    stats.frameSpawns++;
+    if (liveCount > stats.highWater) {
+        stats.highWater = liveCount;
+    }
+}
+
+inline void countAllocation(PoolStats& stats) {
+    stats.allocations++;
+    stats.frameAllocations++;
+}
+
+// Fixed-capacity pool with O(1) spawn and swap-and-pop release. Live objects
+// are always packed in [0, size()), so releasing reorders them.
+template <typename T>
+class ObjectPool {
+public:
+    void reserve(int capacity) {
+        if (capacity > static_cast<int>(items.size())) {
+            items.resize(capacity);
+            countAllocation(stats);
+        }
+    }
+
+    // Returns nullptr when the pool is full.
+    T* spawn() {
+        if (count == static_cast<int>(items.size())) {
+            stats.failedSpawns++;
+            return nullptr;
+        }
+        T* item = &items[count++];
+        *item = T();
+        countSpawn(stats, count);
+        return item;
+    }
+
+    void release(int index) {
+        items[index] = items[--count];
+    }
+
+    void clear() { count = 0; }
+
+    int size() const { return count; }
+    int capacity() const { return static_cast<int>(items.size()); }
+    T& operator[](int index) { return items[index]; }
+    const T& operator[](int index) const { return items[index]; }
+
+    PoolStats stats;
+
+private:
+    std::vector<T> items;
+    int count = 0;
+};
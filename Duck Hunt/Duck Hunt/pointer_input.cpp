@@ -0,0 +1,51 @@
+#include "pointer_input.h"
+
+void pushPointerSample(PointerInput& input, double time, int x, int y) {
+    input.samples[input.next] = {time, x, y};
+    input.next = (input.next + 1) % POINTER_BUFFER_SIZE;
+    if (input.count < POINTER_BUFFER_SIZE) {
+        input.count++;
+    }
+    input.received++;
+
+    if (input.pendingOldest < 0.0) {
+        input.pendingOldest = time;
+    }
+    input.pendingNewest = time;
+}
+
+bool newestPointerSample(const PointerInput& input, PointerSample& sample) {
+    if (input.count == 0) {
+        return false;
+    }
+    sample = input.samples[(input.next + POINTER_BUFFER_SIZE - 1) % POINTER_BUFFER_SIZE];
+    return true;
+}
+
+bool latchPointerFrame(PointerInput& input, PointerSample& sample) {
+    input.latchedOldest = input.pendingOldest;
+    input.latchedNewest = input.pendingNewest;
+    input.pendingOldest = -1.0;
+    input.pendingNewest = -1.0;
+    return newestPointerSample(input, sample);
+}
+
+void presentPointerFrame(PointerInput& input, double swapTime) {
+    if (input.latchedNewest < 0.0) {
+        return;
+    }
+    addSample(input.freshest, (swapTime - input.latchedNewest) * 1000.0);
+    addSample(input.oldest, (swapTime - input.latchedOldest) * 1000.0);
+    input.latchedOldest = -1.0;
+    input.latchedNewest = -1.0;
+}
+
+double pointerSampleRate(const PointerInput& input) {
+    if (input.count < 2) {
+        return 0.0;
+    }
+    const PointerSample& newest = input.samples[(input.next + POINTER_BUFFER_SIZE - 1) % POINTER_BUFFER_SIZE];
+    const PointerSample& oldest = input.samples[(input.next + POINTER_BUFFER_SIZE - input.count) % POINTER_BUFFER_SIZE];
+    double span = newest.time - oldest.time;
+    return span > 0.0 ? (input.count - 1) / span : 0.0;
+}
@@ -0,0 +1,56 @@
+#pragma once
+#include "sample_window.h"
+
+// Pointer samples between frames, kept apart from the simulation so the
+// crosshair can show the freshest position without waiting for a tick.
+// Motion callbacks, and a direct poll of the cursor where the window system
+// has one, push timestamped samples; each frame latches the newest just
+// before the crosshair is drawn and reports back when it was swapped.
+//
+//   pushPointerSample(input, now, x, y);   // motion callback or poll
+//   latchPointerFrame(input, sample);      // before drawing the crosshair
+//   presentPointerFrame(input, now);       // after the buffer swap
+//
+// All times are seconds on one monotonic clock, positions are window
+// pixels as the platform reports them.
+const int POINTER_BUFFER_SIZE = 256;  // Far more than arrive in one frame
+
+struct PointerSample {
+    double time;
+    int x, y;
+};
+
+struct PointerInput {
+    PointerSample samples[POINTER_BUFFER_SIZE];
+    int count = 0;
+    int next = 0;
+    long long received = 0;
+
+    // Arrival times of the oldest and newest sample no frame has shown yet
+    double pendingOldest = -1.0;
+    double pendingNewest = -1.0;
+
+    // The same two for the frame being drawn, -1 if it shows nothing new
+    double latchedOldest = -1.0;
+    double latchedNewest = -1.0;
+
+    // Swap time minus the newest and the oldest sample a frame showed: the
+    // age of the crosshair position and the wait of the longest-held motion
+    SampleWindow freshest;
+    SampleWindow oldest;
+};
+
+void pushPointerSample(PointerInput& input, double time, int x, int y);
+
+// Returns false if no sample has arrived yet.
+bool newestPointerSample(const PointerInput& input, PointerSample& sample);
+
+// newestPointerSample() for the frame about to be drawn, which from now on
+// counts as showing every sample pushed since the last frame.
+bool latchPointerFrame(PointerInput& input, PointerSample& sample);
+
+// Records the latencies of the latched frame if it showed new input.
+void presentPointerFrame(PointerInput& input, double swapTime);
+
+// Samples per second over the buffered samples, 0 with fewer than two.
+double pointerSampleRate(const PointerInput& input);
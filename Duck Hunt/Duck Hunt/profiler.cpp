@@ -0,0 +1,190 @@
+#include "profiler.h"
+#include "gl_ext.h"
+#include "simulation.h"
+#include "text_renderer.h"
+#include <chrono>
+#include <cstdio>
+
+// GPU timestamps are read this many frames after they were issued
+const int QUERY_FRAMES = 4;
+
+// Overlay numbers change too fast to read if refreshed every frame
+const int OVERLAY_REFRESH_FRAMES = 30;
+
+struct PhaseTimer {
+    SampleWindow cpu;
+    SampleWindow gpu;
+    double cpuStart = 0.0;
+
+    // Begin and end timestamp per frame in flight
+    GLuint queries[QUERY_FRAMES][2] = {};
+    bool pending[QUERY_FRAMES] = {};
+};
+
+static const char* phaseNames[PHASE_COUNT] = {
+    "simulation", "background", "ducks", "floating_text", "hud", "crosshair", "present", "frame"
+};
+
+static PhaseTimer timers[PHASE_COUNT];
+static bool gpuTimers = false;
+static int queryFrame = 0;
+
+static double nowMs() {
+    using namespace std::chrono;
+    return duration<double, std::milli>(steady_clock::now().time_since_epoch()).count();
+}
+
+// The simulation does no GL work, so it only has a CPU clock
+static bool hasGpuTimer(int phase) {
+    return gpuTimers && phase != PHASE_SIMULATION;
+}
+
+void initProfiler() {
+    gpuTimers = glExt.timerQueries;
+    if (!gpuTimers) {
+        return;
+    }
+    for (int phase = 0; phase < PHASE_COUNT; ++phase) {
+        if (hasGpuTimer(phase)) {
+            glExt.genQueries(QUERY_FRAMES * 2, &timers[phase].queries[0][0]);
+        }
+    }
+}
+
+void shutdownProfiler() {
+    if (!gpuTimers) {
+        return;
+    }
+    for (int phase = 0; phase < PHASE_COUNT; ++phase) {
+        if (hasGpuTimer(phase)) {
+            glExt.deleteQueries(QUERY_FRAMES * 2, &timers[phase].queries[0][0]);
+        }
+    }
+    gpuTimers = false;
+}
+
+void beginPhase(ProfilePhase phase) {
+    PhaseTimer& timer = timers[phase];
+    timer.cpuStart = nowMs();
+    if (hasGpuTimer(phase) && !timer.pending[queryFrame]) {
+        glExt.queryCounter(timer.queries[queryFrame][0], GL_TIMESTAMP);
+    }
+}
+
+void endPhase(ProfilePhase phase) {
+    PhaseTimer& timer = timers[phase];
+    addSample(timer.cpu, nowMs() - timer.cpuStart);
+    if (hasGpuTimer(phase) && !timer.pending[queryFrame]) {
+        glExt.queryCounter(timer.queries[queryFrame][1], GL_TIMESTAMP);
+        timer.pending[queryFrame] = true;
+    }
+}
+
+void addPhaseSample(ProfilePhase phase, double ms) {
+    addSample(timers[phase].cpu, ms);
+}
+
+void endProfilerFrame() {
+    if (!gpuTimers) {
+        return;
+    }
+
+    // Harvest the oldest frame, which the next frame is about to reuse.
+    // A slot whose result is still not ready is skipped rather than waited on.
+    queryFrame = (queryFrame + 1) % QUERY_FRAMES;
+    for (int phase = 0; phase < PHASE_COUNT; ++phase) {
+        PhaseTimer& timer = timers[phase];
+        if (!hasGpuTimer(phase) || !timer.pending[queryFrame]) {
+            continue;
+        }
+
+        GLint available = 0;
+        glExt.getQueryObjectiv(timer.queries[queryFrame][1], GL_QUERY_RESULT_AVAILABLE, &available);
+        if (!available) {
+            continue;
+        }
+
+        unsigned long long begin = 0, end = 0;
+        glExt.getQueryObjectui64v(timer.queries[queryFrame][0], GL_QUERY_RESULT, &begin);
+        glExt.getQueryObjectui64v(timer.queries[queryFrame][1], GL_QUERY_RESULT, &end);
+        addSample(timer.gpu, (end - begin) / 1.0e6);
+        timer.pending[queryFrame] = false;
+    }
+}
+
+const char* phaseName(ProfilePhase phase) {
+    return phaseNames[phase];
+}
+
+bool gpuProfiling() {
+    return gpuTimers;
+}
+
+SampleStats cpuPhaseStats(ProfilePhase phase) {
+    return sampleStats(timers[phase].cpu);
+}
+
+SampleStats gpuPhaseStats(ProfilePhase phase) {
+    return sampleStats(timers[phase].gpu);
+}
+
+void drawProfilerOverlay() {
+    static char lines[PHASE_COUNT + 1][96];
+    static int framesSinceRefresh = OVERLAY_REFRESH_FRAMES;
+
+    if (++framesSinceRefresh >= OVERLAY_REFRESH_FRAMES) {
+        framesSinceRefresh = 0;
+        snprintf(lines[0], sizeof(lines[0]), "%-14s %-20s  %s", "p50/p95/p99 ms", "cpu", gpuTimers ? "gpu" : "");
+        for (int phase = 0; phase < PHASE_COUNT; ++phase) {
+            SampleStats cpu = cpuPhaseStats(static_cast<ProfilePhase>(phase));
+            SampleStats gpu = gpuPhaseStats(static_cast<ProfilePhase>(phase));
+            char gpuText[32] = "";
+            if (gpu.samples > 0) {
+                snprintf(gpuText, sizeof(gpuText), "%6.2f %6.2f %6.2f", gpu.p50, gpu.p95, gpu.p99);
+            }
+            snprintf(lines[phase + 1], sizeof(lines[phase + 1]), "%-14s %6.2f %6.2f %6.2f  %s",
+                phaseNames[phase], cpu.p50, cpu.p95, cpu.p99, gpuText);
+        }
+    }
+
+    // Darken the area behind the table so it reads over the sky
+    float top = WINDOW_HEIGHT - 5.0f;
+    float bottom = top - 16.0f * (PHASE_COUNT + 1) - 6.0f;
+    glEnable(GL_BLEND);
+    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    glColor4f(0.0f, 0.0f, 0.0f, 0.6f);
+    glBegin(GL_QUADS);
+    glVertex2f(5, bottom);
+    glVertex2f(560, bottom);
+    glVertex2f(560, top);
+    glVertex2f(5, top);
+    glEnd();
+    glDisable(GL_BLEND);
+
+    float y = WINDOW_HEIGHT - 20.0f;
+    for (int i = 0; i <= PHASE_COUNT; ++i) {
+        drawText(TEXT_FIXED_9_BY_15, 10, y, 1.0f, 1.0f, 1.0f, lines[i]);
+        y -= 16.0f;
+    }
+}
+
+static void writeRow(FILE* file, int phase, const char* clock, const SampleStats& stats) {
+    fprintf(file, "%s,%s,%d,%.4f,%.4f,%.4f,%.4f,%.4f\n",
+        phaseNames[phase], clock, stats.samples, stats.mean, stats.p50, stats.p95, stats.p99, stats.max);
+}
+
+bool writeProfileCsv(const char* path) {
+    FILE* file = fopen(path, "w");
+    if (!file) {
+        return false;
+    }
+
+    fprintf(file, "phase,clock,samples,mean_ms,p50_ms,p95_ms,p99_ms,max_ms\n");
+    for (int phase = 0; phase < PHASE_COUNT; ++phase) {
+        writeRow(file, phase, "cpu", cpuPhaseStats(static_cast<ProfilePhase>(phase)));
+        if (hasGpuTimer(phase)) {
+            writeRow(file, phase, "gpu", gpuPhaseStats(static_cast<ProfilePhase>(phase)));
+        }
+    }
+    return fclose(file) == 0;
+}
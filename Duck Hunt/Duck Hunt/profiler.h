@@ -0,0 +1,54 @@
+#pragma once
+#include "sample_window.h"
+
+// Per-phase frame timing. Every phase is timed on the CPU with
+// steady_clock; render phases are also timed on the GPU with timestamp
+// queries when the driver has them (GL 3.3 / ARB_timer_query). GPU results
+// are read back a few frames late so the queries never stall the pipeline.
+//
+//   beginPhase(PHASE_HUD);
+//   drawHud(world);
+//   endPhase(PHASE_HUD);
+//
+// Each phase keeps its last SAMPLE_WINDOW samples, from which the overlay
+// and the CSV report take their percentiles.
+//
+// The soft renderer lays out ducks, popups and HUD under their phases, then
+// rasterizes every layer in one banded pass timed as PHASE_BACKGROUND.
+enum ProfilePhase {
+    PHASE_SIMULATION,
+    PHASE_BACKGROUND,
+    PHASE_DUCKS,
+    PHASE_FLOATING_TEXT,
+    PHASE_HUD,
+    PHASE_CROSSHAIR,
+    PHASE_PRESENT,  // RenderBackend::finishFrame, the soft framebuffer upload
+    PHASE_FRAME,
+    PHASE_COUNT
+};
+
+// Needs glExt loaded. GPU timing stays off when timer queries are missing.
+void initProfiler();
+void shutdownProfiler();
+
+void beginPhase(ProfilePhase phase);
+void endPhase(ProfilePhase phase);
+
+// A CPU sample timed elsewhere, such as a pass of the simulation thread.
+// Call it from the drawing thread like the others.
+void addPhaseSample(ProfilePhase phase, double ms);
+
+// Call once per frame after the last phase; collects finished GPU queries.
+void endProfilerFrame();
+
+const char* phaseName(ProfilePhase phase);
+bool gpuProfiling();
+SampleStats cpuPhaseStats(ProfilePhase phase);
+SampleStats gpuPhaseStats(ProfilePhase phase);
+
+// Queues a table of the current percentiles through drawText(). The caller
+// sets up a WINDOW_WIDTH x WINDOW_HEIGHT ortho projection and flushes text.
+void drawProfilerOverlay();
+
+// One row per phase and clock. Returns false if the file cannot be written.
+bool writeProfileCsv(const char* path);
@@ -0,0 +1,174 @@
+#include "replay.h"
+#include <cstdio>
+
+static const char LOG_MAGIC[4] = {'D', 'H', 'I', 'L'};
+// 2 added the game mode, 3 the spawn rate, 4 the rewind. 5 changed the hit
+// rule to the closest of overlapping ducks, so older logs no longer replay.
+static const int LOG_VERSION = 5;
+
+void applyInput(World& world, const InputEvent& event) {
+    world.pointerX = event.x;
+    world.pointerY = event.y;
+    if (event.type == INPUT_SHOT) {
+        handleShot(world, static_cast<float>(event.x), static_cast<float>(event.y), event.rewind * REWIND_UNIT);
+    }
+}
+
+void submitInput(World& world, InputLog* log, int type, int x, int y, int rewind) {
+    InputEvent event = {world.tick, type, x, y, type == INPUT_SHOT ? rewind : 0};
+    applyInput(world, event);
+    if (log) {
+        log->events.push_back(event);
+    }
+}
+
+void startFromLog(World& world, const InputLog& log) {
+    world.mode = log.mode;
+    world.maxDucks = log.maxDucks > 0 ? log.maxDucks : gameMode(log.mode).maxDucks;
+    world.spawnsPerTick = log.spawnsPerTick > 0 ? log.spawnsPerTick : gameMode(log.mode).spawnsPerTick;
+    seedWorld(world, log.seed);
+    initWorld(world);
+}
+
+void applyLoggedInput(World& world, const InputLog& log, size_t& cursor) {
+    while (cursor < log.events.size() && log.events[cursor].tick <= world.tick) {
+        applyInput(world, log.events[cursor]);
+        cursor++;
+    }
+}
+
+void finishRecording(InputLog& log, const World& world) {
+    log.endTick = world.tick;
+    log.checksum = worldChecksum(world);
+}
+
+// Integers are written byte by byte so the file reads the same on any host
+static void putBytes(FILE* file, uint64_t value, int bytes) {
+    for (int i = 0; i < bytes; ++i) {
+        fputc(static_cast<int>((value >> (8 * i)) & 0xFF), file);
+    }
+}
+
+static bool getBytes(FILE* file, uint64_t& value, int bytes) {
+    value = 0;
+    for (int i = 0; i < bytes; ++i) {
+        int c = fgetc(file);
+        if (c == EOF) {
+            return false;
+        }
+        value |= static_cast<uint64_t>(c) << (8 * i);
+    }
+    return true;
+}
+
+static void putVarint(FILE* file, uint64_t value) {
+    while (value >= 0x80) {
+        fputc(static_cast<int>((value & 0x7F) | 0x80), file);
+        value >>= 7;
+    }
+    fputc(static_cast<int>(value), file);
+}
+
+static bool getVarint(FILE* file, uint64_t& value) {
+    value = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+        int c = fgetc(file);
+        if (c == EOF) {
+            return false;
+        }
+        value |= static_cast<uint64_t>(c & 0x7F) << shift;
+        if (!(c & 0x80)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool writeInputLog(const char* path, const InputLog& log) {
+    FILE* file = fopen(path, "wb");
+    if (!file) {
+        return false;
+    }
+
+    fwrite(LOG_MAGIC, 1, sizeof(LOG_MAGIC), file);
+    putBytes(file, LOG_VERSION, 2);
+    putBytes(file, log.seed, 8);
+    putBytes(file, static_cast<uint32_t>(log.maxDucks), 4);
+    putBytes(file, static_cast<uint32_t>(log.mode), 1);
+    putBytes(file, static_cast<uint32_t>(log.spawnsPerTick), 4);
+    putBytes(file, static_cast<uint64_t>(log.endTick), 8);
+    putBytes(file, log.checksum, 4);
+    putBytes(file, log.events.size(), 8);
+
+    long long tick = 0;
+    for (const InputEvent& event : log.events) {
+        putVarint(file, static_cast<uint64_t>(event.tick - tick));
+        fputc(event.type, file);
+        putBytes(file, static_cast<uint16_t>(event.x), 2);
+        putBytes(file, static_cast<uint16_t>(event.y), 2);
+        if (event.type == INPUT_SHOT) {
+            putVarint(file, static_cast<uint64_t>(event.rewind));
+        }
+        tick = event.tick;
+    }
+
+    bool ok = !ferror(file);
+    return fclose(file) == 0 && ok;
+}
+
+bool readInputLog(const char* path, InputLog& log) {
+    FILE* file = fopen(path, "rb");
+    if (!file) {
+        return false;
+    }
+
+    char magic[4];
+    uint64_t version, seed, maxDucks, mode, spawnsPerTick, endTick, checksum, count;
+    bool ok = fread(magic, 1, sizeof(magic), file) == sizeof(magic)
+        && magic[0] == LOG_MAGIC[0] && magic[1] == LOG_MAGIC[1]
+        && magic[2] == LOG_MAGIC[2] && magic[3] == LOG_MAGIC[3]
+        && getBytes(file, version, 2);
+    if (ok && version >= 1 && version < LOG_VERSION) {
+        fprintf(stderr, "%s is a version %d replay log, recorded before shots picked the closest of overlapping ducks; it would not replay the same\n",
+            path, static_cast<int>(version));
+        fclose(file);
+        return false;
+    }
+    ok = ok && version == LOG_VERSION
+        && getBytes(file, seed, 8)
+        && getBytes(file, maxDucks, 4)
+        && getBytes(file, mode, 1) && mode < MODE_COUNT
+        && getBytes(file, spawnsPerTick, 4)
+        && getBytes(file, endTick, 8)
+        && getBytes(file, checksum, 4)
+        && getBytes(file, count, 8);
+
+    log.events.clear();
+    long long tick = 0;
+    for (uint64_t i = 0; ok && i < count; ++i) {
+        uint64_t delta, x, y;
+        uint64_t rewind = 0;
+        int type = 0;
+        ok = getVarint(file, delta)
+            && (type = fgetc(file)) != EOF
+            && getBytes(file, x, 2)
+            && getBytes(file, y, 2)
+            && (type != INPUT_SHOT || (getVarint(file, rewind) && rewind <= 0xFFFF));
+        if (ok) {
+            tick += static_cast<long long>(delta);
+            InputEvent event = {tick, type, static_cast<int16_t>(x), static_cast<int16_t>(y), static_cast<int>(rewind)};
+            log.events.push_back(event);
+        }
+    }
+    fclose(file);
+
+    if (ok) {
+        log.mode = static_cast<int>(mode);
+        log.spawnsPerTick = static_cast<int>(spawnsPerTick);
+        log.seed = seed;
+        log.maxDucks = static_cast<int>(maxDucks);
+        log.endTick = static_cast<long long>(endTick);
+        log.checksum = static_cast<uint32_t>(checksum);
+    }
+    return ok;
+}
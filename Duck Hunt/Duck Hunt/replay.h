@@ -0,0 +1,64 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "simulation.h"
+
+// Player input as data. The GLUT callbacks, the headless shooter and replay
+// all turn input into InputEvents and hand them to applyInput(), so a log of
+// the events applied during a game is enough to play it again exactly.
+//
+// An event carries the World::tick it was applied at: it happened after that
+// many steps and before the next one. Coordinates are in window pixels with
+// y pointing up, as the simulation uses them. A shot also carries how far
+// behind that tick the frame the player aimed at was, so it can be tested
+// against the ducks where they were drawn.
+enum InputType {
+    INPUT_MOTION,
+    INPUT_SHOT
+};
+
+struct InputEvent {
+    long long tick;
+    int type;
+    int x, y;
+    int rewind;  // Shots only, in 1/256 ticks; 0 tests the current ducks
+};
+
+const float REWIND_UNIT = 1.0f / 256.0f;
+
+void applyInput(World& world, const InputEvent& event);
+
+// Everything needed to replay a session: the mode, seed, flock size and
+// spawn rate it started with, its events, and where it ended and in what state.
+struct InputLog {
+    int mode = MODE_CLASSIC;
+    uint64_t seed = 0;
+    int maxDucks = 0;       // 0: the mode's MAX_DUCKS
+    int spawnsPerTick = 0;  // 0: the mode's SPAWNS_PER_TICK
+    std::vector<InputEvent> events;
+    long long endTick = 0;
+    uint32_t checksum = 0;  // worldChecksum() at endTick
+};
+
+// Stamps an event with the world's current tick, applies it and appends it
+// to log if there is one.
+void submitInput(World& world, InputLog* log, int type, int x, int y, int rewind = 0);
+
+// Sets up a World in the state the log was recorded from.
+void startFromLog(World& world, const InputLog& log);
+
+// Applies the log's events for the world's current tick, starting at cursor,
+// and advances cursor past them. Call before each stepWorld().
+void applyLoggedInput(World& world, const InputLog& log, size_t& cursor);
+
+// Fills in endTick and checksum from the world at the end of a recording.
+void finishRecording(InputLog& log, const World& world);
+
+// Compact little-endian binary format: a header, then per event the tick
+// delta as a varint, the type and 16-bit coordinates, and for shots the
+// rewind as a varint. Return false on I/O
+// errors or a malformed file. Logs from before the current version are
+// refused with a message, since the rules they were recorded under changed.
+bool writeInputLog(const char* path, const InputLog& log);
+bool readInputLog(const char* path, InputLog& log);
@@ -0,0 +1,38 @@
+#pragma once
+#include <cstdint>
+
+// PCG32 (O'Neill, pcg-random.org): 64-bit LCG state with a permuted 32-bit
+// output. Only integer arithmetic with fixed widths is involved, so a given
+// seed and stream produce the same numbers with every compiler and C
+// library, unlike rand(). Different stream ids give independent sequences
+// from the same seed.
+struct Pcg32 {
+    uint64_t state = 0;
+    uint64_t increment = 1;
+};
+
+inline uint32_t nextRandom(Pcg32& rng) {
+    uint64_t old = rng.state;
+    rng.state = old * 6364136223846793005ULL + rng.increment;
+    uint32_t xorShifted = static_cast<uint32_t>(((old >> 18) ^ old) >> 27);
+    uint32_t rotation = static_cast<uint32_t>(old >> 59);
+    return (xorShifted >> rotation) | (xorShifted << ((32 - rotation) & 31));
+}
+
+inline void seedRandom(Pcg32& rng, uint64_t seed, uint64_t stream) {
+    rng.state = 0;
+    rng.increment = (stream << 1) | 1;
+    nextRandom(rng);
+    rng.state += seed;
+    nextRandom(rng);
+}
+
+// Uniform in [0, 1). The top 24 bits fill the float mantissa exactly.
+inline float randomFloat(Pcg32& rng) {
+    return static_cast<float>(nextRandom(rng) >> 8) * (1.0f / 16777216.0f);
+}
+
+// Uniform in [0, n) for small n; the bias is below n / 2^32.
+inline int randomBelow(Pcg32& rng, int n) {
+    return static_cast<int>((static_cast<uint64_t>(nextRandom(rng)) * static_cast<uint32_t>(n)) >> 32);
+}
@@ -0,0 +1,82 @@
+#pragma once
+
+// Tuning constants of a game mode as a policy type. The rule code in
+// simulation.cpp is templated on the policy, so each mode is its own
+// instantiation with its constants folded in; nothing on the hot path reads
+// a variable for them. A mode overrides what differs from ClassicRules.
+struct ClassicRules {
+    static constexpr int MAX_DUCKS = 3;
+    static constexpr int SPAWNS_PER_TICK = 1;  // Most ducks topped up per tick
+    static constexpr float DUCK_SPEED = 3.0f;
+    static constexpr int SHOT_RADIUS = 20;
+    static constexpr int GAME_DURATION = 60;
+    static constexpr int SHOTS_PER_ROUND = 10;
+    static constexpr int BASE_POINTS = 500;
+    static constexpr int BONUS_POINTS = 500;
+    static constexpr float MAX_BONUS_TIME = 2.0f;
+};
+
+// A busy sky of fast ducks worth little each, with a short bonus window
+struct SwarmRules : ClassicRules {
+    static constexpr int MAX_DUCKS = 40;
+    static constexpr float DUCK_SPEED = 4.5f;
+    static constexpr int GAME_DURATION = 45;
+    static constexpr int SHOTS_PER_ROUND = 30;
+    static constexpr int BASE_POINTS = 100;
+    static constexpr int BONUS_POINTS = 100;
+    static constexpr float MAX_BONUS_TIME = 0.5f;
+};
+
+// One quick duck at a time and a shot that has to land almost dead on
+struct SniperRules : ClassicRules {
+    static constexpr int MAX_DUCKS = 1;
+    static constexpr float DUCK_SPEED = 5.0f;
+    static constexpr int SHOT_RADIUS = 2;
+    static constexpr int SHOTS_PER_ROUND = 5;
+    static constexpr int BASE_POINTS = 1000;
+    static constexpr int BONUS_POINTS = 1000;
+    static constexpr float MAX_BONUS_TIME = 3.0f;
+};
+
+// Scalability benchmark: ten thousand ducks, refilled in large batches
+struct StressRules : ClassicRules {
+    static constexpr int MAX_DUCKS = 10000;
+    static constexpr int SPAWNS_PER_TICK = 100;
+    static constexpr int SHOTS_PER_ROUND = 100;
+    static constexpr int BASE_POINTS = 50;
+    static constexpr int BONUS_POINTS = 50;
+    static constexpr float MAX_BONUS_TIME = 0.25f;
+};
+
+template <typename Rules>
+constexpr int bestScore() {
+    return Rules::SHOTS_PER_ROUND * (Rules::BASE_POINTS + Rules::BONUS_POINTS);
+}
+
+enum GameModeId {
+    MODE_CLASSIC,
+    MODE_SWARM,
+    MODE_SNIPER,
+    MODE_STRESS,
+    MODE_COUNT
+};
+
+struct World;
+
+// Runtime view of one instantiation: its entry points and the few
+// constants the front ends show or report.
+struct GameMode {
+    const char* name;
+    int maxDucks;
+    int spawnsPerTick;
+    int shotsPerRound;
+    int bestScore;
+    void (*init)(World& world);
+    void (*step)(World& world, float dt);
+    void (*shot)(World& world, float x, float y, float rewind);
+};
+
+const GameMode& gameMode(int mode);
+
+// Returns the GameModeId called name, or -1.
+int findGameMode(const char* name);
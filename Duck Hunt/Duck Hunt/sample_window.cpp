@@ -0,0 +1,33 @@
+#include "sample_window.h"
+#include <algorithm>
+
+void addSample(SampleWindow& window, double ms) {
+    window.samples[window.next] = static_cast<float>(ms);
+    window.next = (window.next + 1) % SAMPLE_WINDOW;
+    if (window.count < SAMPLE_WINDOW) {
+        window.count++;
+    }
+}
+
+SampleStats sampleStats(const SampleWindow& window) {
+    SampleStats stats = {window.count, 0.0, 0.0, 0.0, 0.0, 0.0};
+    if (window.count == 0) {
+        return stats;
+    }
+
+    float sorted[SAMPLE_WINDOW];
+    std::copy(window.samples, window.samples + window.count, sorted);
+    std::sort(sorted, sorted + window.count);
+
+    double sum = 0.0;
+    for (int i = 0; i < window.count; ++i) {
+        sum += sorted[i];
+    }
+    int last = window.count - 1;
+    stats.mean = sum / window.count;
+    stats.p50 = sorted[last * 50 / 100];
+    stats.p95 = sorted[last * 95 / 100];
+    stats.p99 = sorted[last * 99 / 100];
+    stats.max = sorted[last];
+    return stats;
+}
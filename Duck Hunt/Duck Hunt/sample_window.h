@@ -0,0 +1,22 @@
+#pragma once
+
+// The last SAMPLE_WINDOW timings of something, in milliseconds, and their
+// percentiles. Frame phases and pointer latency are both reported this way.
+const int SAMPLE_WINDOW = 512;
+
+struct SampleWindow {
+    float samples[SAMPLE_WINDOW];
+    int count = 0;
+    int next = 0;
+};
+
+struct SampleStats {
+    int samples;
+    double mean, p50, p95, p99, max;  // Milliseconds
+};
+
+// Replaces the oldest sample once the window is full.
+void addSample(SampleWindow& window, double ms);
+
+// All zero for an empty window.
+SampleStats sampleStats(const SampleWindow& window);
@@ -0,0 +1,50 @@
+#include "shapes.h"
+#include "gl_ext.h"
+#include "text_renderer.h"
+#include <cstdio>
+
+static const GLenum glModes[] = {GL_TRIANGLES, GL_QUADS, GL_POLYGON, GL_LINES, GL_LINE_STRIP, GL_LINE_LOOP};
+
+void clearShapes(ShapeList& list) {
+    list.shapes.clear();
+    list.points.clear();
+    list.texts.clear();
+}
+
+void beginShape(ShapeList& list, ShapeKind kind, float r, float g, float b, float lineWidth) {
+    Shape shape = {kind, {r, g, b}, lineWidth, static_cast<int>(list.points.size() / 2), 0};
+    list.shapes.push_back(shape);
+}
+
+void addPoint(ShapeList& list, float x, float y) {
+    list.points.push_back(x);
+    list.points.push_back(y);
+    list.shapes.back().count++;
+}
+
+void addShapeText(ShapeList& list, int font, float x, float y, float r, float g, float b, const char* text) {
+    ShapeText entry = {font, x, y, {r, g, b, 1.0f}, ""};
+    snprintf(entry.text, sizeof(entry.text), "%s", text);
+    list.texts.push_back(entry);
+}
+
+void drawShapes(const ShapeList& list) {
+    for (const Shape& shape : list.shapes) {
+        if (shape.kind >= SHAPE_LINES) {
+            glLineWidth(shape.lineWidth);
+        }
+        glColor3fv(shape.color);
+        glBegin(glModes[shape.kind]);
+        for (int i = 0; i < shape.count; ++i) {
+            glVertex2fv(&list.points[2 * (shape.first + i)]);
+        }
+        glEnd();
+    }
+    if (list.texts.empty()) {
+        return;
+    }
+    for (const ShapeText& text : list.texts) {
+        drawText(text.font, text.x, text.y, text.color[0], text.color[1], text.color[2], text.color[3], text.text);
+    }
+    flushText();
+}
@@ -0,0 +1,48 @@
+#pragma once
+#include <vector>
+
+// Flat-coloured 2D geometry recorded once and drawn by either renderer:
+// the GL path replays it as immediate-mode primitives, the software
+// rasterizer fills it into its framebuffer. Coordinates are in the game's
+// WINDOW_WIDTH x WINDOW_HEIGHT space, y up. Text goes on top of every
+// shape of the list, as the GL path batches it into one flush.
+enum ShapeKind {
+    SHAPE_TRIANGLES,
+    SHAPE_QUADS,
+    SHAPE_POLYGON,     // Convex, filled as a fan around its first point
+    SHAPE_LINES,
+    SHAPE_LINE_STRIP,
+    SHAPE_LINE_LOOP
+};
+
+struct Shape {
+    ShapeKind kind;
+    float color[3];
+    float lineWidth;  // Line kinds only
+    int first;        // Into ShapeList::points, in points
+    int count;
+};
+
+struct ShapeText {
+    int font;  // TextFont
+    float x, y;
+    float color[4];
+    char text[32];
+};
+
+struct ShapeList {
+    std::vector<Shape> shapes;
+    std::vector<float> points;  // x, y pairs
+    std::vector<ShapeText> texts;
+};
+
+void clearShapes(ShapeList& list);
+
+// Starts a shape; the points added until the next beginShape() belong to it.
+void beginShape(ShapeList& list, ShapeKind kind, float r, float g, float b, float lineWidth = 1.0f);
+void addPoint(ShapeList& list, float x, float y);
+void addShapeText(ShapeList& list, int font, float x, float y, float r, float g, float b, const char* text);
+
+// Replays the list through GL in the current projection, text through
+// drawText() and one flushText().
+void drawShapes(const ShapeList& list);
@@ -0,0 +1,145 @@
+#include "sim_thread.h"
+#include <chrono>
+
+static void publish(SimThread& sim, double passMs, bool replayFinished) {
+    // Copy-assigning into the slot reuses its arrays, so once every slot
+    // has held a full flock this allocates nothing
+    SimSnapshot& snapshot = sim.snapshots.back();
+    snapshot.world = sim.world;
+    snapshot.stepTime = sim.loop.lastTime - sim.loop.accumulator;
+    snapshot.passMs = passMs;
+    snapshot.replayFinished = replayFinished;
+    sim.snapshots.publish();
+}
+
+// How many 1/256 ticks the world has moved on since the shot's frame
+static int shotRewind(const World& world, double shownTick) {
+    if (shownTick < 0.0) {
+        return 0;
+    }
+    double rewind = static_cast<double>(world.tick) - shownTick;
+    rewind = rewind < DUCK_HISTORY ? rewind : DUCK_HISTORY;
+    return rewind > 0.0 ? static_cast<int>(rewind / REWIND_UNIT + 0.5) : 0;
+}
+
+static void runSimulation(SimThread& sim) {
+    using namespace std::chrono;
+    bool replayFinished = false;
+    for (;;) {
+        // Sleep until the next tick is due or input arrives
+        double due = sim.loop.lastTime + SIM_STEP - sim.loop.accumulator;
+        double wait = replayFinished ? 3600.0 : due - sim.clock();
+        bool woken;
+        {
+            std::unique_lock<std::mutex> lock(sim.wakeLock);
+            woken = sim.wake.wait_for(lock, duration<double>(wait > 0.0 ? wait : 0.0),
+                [&] { return sim.stopping || sim.inputPosted; });
+            if (sim.stopping) {
+                return;
+            }
+            sim.inputPosted = false;
+        }
+
+        double begin = sim.clock();
+        if (!woken && !replayFinished) {
+            double lateMs = (begin - due) * 1000.0;
+            lateMs = lateMs > 0.0 ? lateMs : 0.0;
+            sim.lateWakes.fetch_add(1, std::memory_order_relaxed);
+            sim.lateMsTotal.store(sim.lateMsTotal.load(std::memory_order_relaxed) + lateMs, std::memory_order_relaxed);
+            if (lateMs > sim.lateMsMax.load(std::memory_order_relaxed)) {
+                sim.lateMsMax.store(lateMs, std::memory_order_relaxed);
+            }
+        }
+
+        bool changed = false;
+        SimInput event;
+        while (sim.input.pop(event)) {
+            if (!replayFinished) {
+                submitInput(sim.world, sim.recordLog, event.type, event.x, event.y, shotRewind(sim.world, event.shownTick));
+                changed = true;
+            }
+        }
+        if (replayFinished) {
+            continue;
+        }
+
+        int steps = advanceGameLoop(sim.loop, sim.world, begin);
+        if (sim.loop.replay && sim.world.tick >= sim.loop.replay->endTick) {
+            // Input logged after the last tick still belongs to the game
+            applyLoggedInput(sim.world, *sim.loop.replay, sim.loop.replayCursor);
+            replayFinished = true;
+        }
+
+        if (steps > 0 || changed || replayFinished) {
+            publish(sim, (sim.clock() - begin) * 1000.0, replayFinished);
+        }
+        if (steps > 0) {
+            sim.passes.fetch_add(1, std::memory_order_relaxed);
+            sim.ticks.fetch_add(steps, std::memory_order_relaxed);
+        }
+        if (steps > 1) {
+            sim.catchUpPasses.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+}
+
+void startSimThread(SimThread& sim, double (*clock)()) {
+    sim.clock = clock;
+    sim.stopping = false;
+    // The first call only starts the loop's clock
+    advanceGameLoop(sim.loop, sim.world, clock());
+    publish(sim, 0.0, false);
+    sim.snapshots.update();
+    sim.thread = std::thread(runSimulation, std::ref(sim));
+}
+
+void stopSimThread(SimThread& sim) {
+    if (!sim.thread.joinable()) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(sim.wakeLock);
+        sim.stopping = true;
+    }
+    sim.wake.notify_one();
+    sim.thread.join();
+}
+
+bool postSimInput(SimThread& sim, int type, int x, int y, double shownTick) {
+    SimInput event = {type, x, y, shownTick};
+    if (!sim.input.push(event)) {
+        sim.inputDropped.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    // Motion only moves the pointer the crosshair does not draw from, so
+    // it waits for the next tick instead of costing a pass of its own
+    if (type != INPUT_SHOT) {
+        return true;
+    }
+    {
+        std::lock_guard<std::mutex> lock(sim.wakeLock);
+        sim.inputPosted = true;
+    }
+    sim.wake.notify_one();
+    return true;
+}
+
+bool takeSimSnapshot(SimThread& sim) {
+    return sim.snapshots.update();
+}
+
+const SimSnapshot& simSnapshot(const SimThread& sim) {
+    return sim.snapshots.front();
+}
+
+SimStats simStats(const SimThread& sim) {
+    SimStats stats;
+    stats.passes = sim.passes.load(std::memory_order_relaxed);
+    stats.ticks = sim.ticks.load(std::memory_order_relaxed);
+    stats.catchUpPasses = sim.catchUpPasses.load(std::memory_order_relaxed);
+    stats.inputDropped = sim.inputDropped.load(std::memory_order_relaxed);
+    long long wakes = sim.lateWakes.load(std::memory_order_relaxed);
+    stats.meanLateMs = wakes > 0 ? sim.lateMsTotal.load(std::memory_order_relaxed) / wakes : 0.0;
+    stats.maxLateMs = sim.lateMsMax.load(std::memory_order_relaxed);
+    return stats;
+}
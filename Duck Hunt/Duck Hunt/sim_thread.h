@@ -0,0 +1,95 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include "game_loop.h"
+#include "replay.h"
+#include "spsc_queue.h"
+#include "triple_buffer.h"
+
+// The simulation on a thread of its own. It runs the simulation half of a
+// GameLoop against real time and, after every pass that ran a tick or
+// applied input, publishes a copy of the World through a TripleBuffer. The
+// drawing thread takes the newest copy without ever waiting, so a slow
+// frame never holds up a tick. Input goes the other way through a
+// wait-free queue.
+//
+//   startSimThread(sim, clock);           // sim.world and sim.loop set up first
+//   postSimInput(sim, INPUT_SHOT, x, y, shownTick);  // input callbacks
+//   takeSimSnapshot(sim);                 // before each frame
+//   simSnapshot(sim).world                // what to draw
+//   stopSimThread(sim);                   // before touching sim.world again
+//
+// Only the thread that started the simulation may post input and take
+// snapshots.
+struct SimSnapshot {
+    World world;
+    double stepTime = 0.0;        // Clock time the world's last tick was due
+    double passMs = 0.0;          // How long the pass that published it took
+    bool replayFinished = false;  // world is the replay's final state
+};
+
+// Input on its way to the simulation thread
+struct SimInput {
+    int type;
+    int x, y;
+    double shownTick;  // See postSimInput()
+};
+
+struct SimStats {
+    long long passes;
+    long long ticks;
+    long long catchUpPasses;  // Passes that had to run more than one tick
+    long long inputDropped;   // Input refused because the queue was full
+    double meanLateMs;        // How far past its due time a tick woke up
+    double maxLateMs;
+};
+
+struct SimThread {
+    // Owned by the thread while it runs. loop.replay, loop.bot and
+    // recordLog must stay put until stopSimThread().
+    World world;
+    GameLoop loop;
+    InputLog* recordLog = nullptr;  // Live input is appended here when set
+
+    double (*clock)() = nullptr;  // Seconds, shared with the drawing thread
+    TripleBuffer<SimSnapshot> snapshots;
+    SpscQueue<SimInput, 256> input;
+    std::thread thread;
+
+    std::mutex wakeLock;  // Guards the sleep, never the handoff
+    std::condition_variable wake;
+    bool inputPosted = false;
+    bool stopping = false;
+
+    std::atomic<long long> passes{0};
+    std::atomic<long long> ticks{0};
+    std::atomic<long long> catchUpPasses{0};
+    std::atomic<long long> inputDropped{0};
+    std::atomic<long long> lateWakes{0};  // Wakes for a due tick
+    std::atomic<double> lateMsTotal{0.0};
+    std::atomic<double> lateMsMax{0.0};
+};
+
+// Publishes the starting world and starts the thread.
+void startSimThread(SimThread& sim, double (*clock)());
+
+// Stops and joins the thread. Does nothing if it is not running.
+void stopSimThread(SimThread& sim);
+
+// Queues player input, coordinates with y up. A shot wakes the thread to
+// apply it at once; motion waits for the next tick. shownTick is where the
+// frame on screen was in simulation time, the snapshot's tick - 1 plus the
+// interpolation alpha it was drawn with; a shot is tested against the ducks
+// as they were then. Negative tests the ducks as they are when it lands.
+// Returns false if the queue is full and the input was dropped.
+bool postSimInput(SimThread& sim, int type, int x, int y, double shownTick = -1.0);
+
+// Moves to the newest published snapshot. Returns false if there is none
+// newer than the current one.
+bool takeSimSnapshot(SimThread& sim);
+
+const SimSnapshot& simSnapshot(const SimThread& sim);
+
+SimStats simStats(const SimThread& sim);
@@ -0,0 +1,277 @@
+#include "simulation.h"
+#include "telemetry.h"
+#include <algorithm>
+#include <cstring>
+
+enum SpawnStream {
+    STREAM_SIDE = 1,
+    STREAM_COLOR,
+    STREAM_HEIGHT,
+    STREAM_VELOCITY
+};
+
+void seedWorld(World& world, uint64_t seed) {
+    seedRandom(world.random.side, seed, STREAM_SIDE);
+    seedRandom(world.random.color, seed, STREAM_COLOR);
+    seedRandom(world.random.height, seed, STREAM_HEIGHT);
+    seedRandom(world.random.velocity, seed, STREAM_VELOCITY);
+}
+
+template <typename Rules>
+static void spawnDuck(World& world);
+
+static void recordEvent(World& world, TelemetryEvent type, float x, float y, int points = 0, int bonus = 0, float timeSinceSpawn = 0.0f) {
+    if (!world.telemetry) {
+        return;
+    }
+    TelemetryRecord record = {world.tick, static_cast<uint16_t>(type), static_cast<uint16_t>(world.mode),
+        x, y, points, bonus, timeSinceSpawn};
+    recordTelemetry(*world.telemetry, record);
+}
+
+template <typename Rules>
+static void initWorldWith(World& world) {
+    // Ducks that died this tick are only released after the top-up
+    reserveDucks(world.ducks, world.maxDucks + world.spawnsPerTick);
+    world.floatingTexts.reserve(MAX_FLOATING_TEXTS);
+    clearDucks(world.ducks);
+    world.floatingTexts.clear();
+    world.score = 0;
+    world.timeRemaining = Rules::GAME_DURATION;
+    world.gameOver = false;
+    world.missedShots = 0;
+    world.totalShots = 0;
+    world.shotsRemaining = Rules::SHOTS_PER_ROUND;
+    world.roundOver = false;
+    world.secondAccumulator = 0.0f;
+    world.hudVersion++;
+
+    for (int i = 0; i < world.maxDucks; ++i) {
+        spawnDuck<Rules>(world);
+    }
+    recordDuckHistory(world.ducks, world.tick);
+}
+
+template <typename Rules>
+static void spawnDuck(World& world) {
+    SpawnRandom& random = world.random;
+    int color = randomBelow(random.color, 2);
+    int bodyColor = color; // Default to matching body color
+
+    // For green ducks (color index 1), use the white body color
+    if (color == 1) {
+        bodyColor = 1; // Use white body for green ducks
+    }
+
+    float x, dx;
+    if (randomBelow(random.side, 2) == 0) {
+        x = -DUCK_SIZE;
+        dx = Rules::DUCK_SPEED * (0.5f + randomFloat(random.velocity));
+    }
+    else {
+        x = WINDOW_WIDTH + DUCK_SIZE;
+        dx = -Rules::DUCK_SPEED * (0.5f + randomFloat(random.velocity));
+    }
+
+    float y = WINDOW_HEIGHT / 2 + (WINDOW_HEIGHT / 3) * randomFloat(random.height);
+    float dy = Rules::DUCK_SPEED * 0.5f * (randomFloat(random.velocity) - 0.5f);
+
+    if (world.ducks.count == 0) {
+        world.duckSpawnTime = static_cast<float>(world.time);
+    }
+
+    if (addDuck(world.ducks, x, y, dx, dy, color, bodyColor) != -1) {
+        recordEvent(world, TELEMETRY_SPAWN, x, y);
+    }
+}
+
+static void updateFloatingTexts(World& world, float ticks) {
+    ObjectPool<FloatingText>& texts = world.floatingTexts;
+    int i = 0;
+    while (i < texts.size()) {
+        texts[i].y += texts[i].speed * ticks;
+        texts[i].alpha -= 0.02f * ticks;
+
+        if (texts[i].alpha <= 0.0f) {
+            texts.release(i);
+        }
+        else {
+            i++;
+        }
+    }
+}
+
+template <typename Rules>
+static void stepWorldWith(World& world, float dt) {
+    world.tick++;
+    world.time += dt;
+    float ticks = dt / SIM_STEP;
+
+    beginPoolFrame(world.ducks.stats);
+    beginPoolFrame(world.floatingTexts.stats);
+    snapshotDucks(world.ducks);
+
+    // Score popups keep drifting on the game over screen
+    updateFloatingTexts(world, ticks);
+
+    if (world.gameOver || world.roundOver) {
+        return;
+    }
+
+    world.secondAccumulator += dt;
+    while (world.secondAccumulator >= 1.0f) {
+        world.secondAccumulator -= 1.0f;
+        world.timeRemaining--;
+    }
+    if (world.timeRemaining <= 0) {
+        world.timeRemaining = 0;
+        world.gameOver = true;
+        world.hudVersion++;
+        recordEvent(world, TELEMETRY_GAME_OVER, 0.0f, 0.0f, world.score, world.totalShots);
+    }
+
+    int activeDucks = updateDucks(world.ducks, ticks);
+
+    // Top up in one batch, never past the slots the dead ducks still hold
+    int missing = std::min(world.maxDucks - activeDucks, world.spawnsPerTick);
+    missing = std::min(missing, world.ducks.capacity - world.ducks.count);
+    for (int i = 0; i < missing; ++i) {
+        spawnDuck<Rules>(world);
+    }
+
+    // The only ducks dead before the release are the ones that flew off
+    if (world.telemetry) {
+        const DuckPool& ducks = world.ducks;
+        for (int i = 0; i < ducks.count; ++i) {
+            if (!ducks.alive[i]) {
+                recordEvent(world, TELEMETRY_ESCAPE, ducks.x[i], ducks.y[i]);
+            }
+        }
+    }
+    releaseDeadDucks(world.ducks);
+    recordDuckHistory(world.ducks, world.tick);
+}
+
+template <typename Rules>
+static void handleShotWith(World& world, float x, float y, float rewind) {
+    if (world.gameOver || world.roundOver) {
+        initWorldWith<Rules>(world);
+        return;
+    }
+
+    // Every shot below changes shotsRemaining or roundOver
+    world.hudVersion++;
+
+    if (world.shotsRemaining <= 0) {
+        world.roundOver = true;
+        recordEvent(world, TELEMETRY_ROUND_OVER, 0.0f, 0.0f, world.score, world.totalShots);
+        return;
+    }
+
+    world.shotsRemaining--;
+    world.totalShots++;
+
+    DuckPool& ducks = world.ducks;
+    float radius = static_cast<float>(Rules::SHOT_RADIUS + DUCK_SIZE);
+    int i = rewind > 0.0f ? findDuckAtPast(ducks, x, y, radius, rewind) : findDuckAt(ducks, x, y, radius);
+    if (i != -1) {
+        float currentTime = static_cast<float>(world.time);
+        float timeSinceSpawn = currentTime - world.duckSpawnTime;
+
+        int bonusPoints = 0;
+        if (timeSinceSpawn <= Rules::MAX_BONUS_TIME) {
+            bonusPoints = Rules::BONUS_POINTS;
+        }
+        else if (timeSinceSpawn <= Rules::MAX_BONUS_TIME * 2) {
+            float bonusFactor = 1.0f - (timeSinceSpawn - Rules::MAX_BONUS_TIME) / Rules::MAX_BONUS_TIME;
+            bonusPoints = static_cast<int>(Rules::BONUS_POINTS * bonusFactor);
+        }
+
+        int pointsEarned = Rules::BASE_POINTS + bonusPoints;
+        world.score += pointsEarned;
+
+        addFloatingText(world, ducks.x[i], ducks.y[i], pointsEarned);
+        recordEvent(world, TELEMETRY_HIT, ducks.x[i], ducks.y[i], pointsEarned, bonusPoints, timeSinceSpawn);
+
+        releaseDuck(ducks, i);
+        world.duckSpawnTime = currentTime;
+    }
+    else {
+        world.missedShots++;
+        recordEvent(world, TELEMETRY_MISS, x, y);
+    }
+
+    if (world.shotsRemaining <= 0) {
+        world.roundOver = true;
+        recordEvent(world, TELEMETRY_ROUND_OVER, 0.0f, 0.0f, world.score, world.totalShots);
+    }
+}
+
+template <typename Rules>
+static constexpr GameMode makeGameMode(const char* name) {
+    return {name, Rules::MAX_DUCKS, Rules::SPAWNS_PER_TICK, Rules::SHOTS_PER_ROUND, bestScore<Rules>(),
+        initWorldWith<Rules>, stepWorldWith<Rules>, handleShotWith<Rules>};
+}
+
+static constexpr GameMode gameModes[MODE_COUNT] = {
+    makeGameMode<ClassicRules>("classic"),
+    makeGameMode<SwarmRules>("swarm"),
+    makeGameMode<SniperRules>("sniper"),
+    makeGameMode<StressRules>("stress"),
+};
+
+const GameMode& gameMode(int mode) {
+    return gameModes[mode];
+}
+
+int findGameMode(const char* name) {
+    for (int mode = 0; mode < MODE_COUNT; ++mode) {
+        if (strcmp(gameModes[mode].name, name) == 0) {
+            return mode;
+        }
+    }
+    return -1;
+}
+
+void initWorld(World& world) {
+    gameModes[world.mode].init(world);
+}
+
+void stepWorld(World& world, float dt) {
+    gameModes[world.mode].step(world, dt);
+}
+
+void handleShot(World& world, float x, float y, float rewind) {
+    gameModes[world.mode].shot(world, x, y, rewind);
+}
+
+void addFloatingText(World& world, float x, float y, int points) {
+    FloatingText* ft = world.floatingTexts.spawn();
+    if (!ft) {
+        return;
+    }
+    ft->x = x;
+    ft->y = y;
+    ft->alpha = 1.0f;
+    ft->speed = 1.0f;
+    ft->points = points;
+}
+
+uint32_t worldChecksum(const World& world) {
+    uint32_t hash = 2166136261u;
+    auto mix = [&hash](uint32_t value) {
+        for (int i = 0; i < 4; ++i) {
+            hash = (hash ^ ((value >> (8 * i)) & 0xFF)) * 16777619u;
+        }
+    };
+    for (int i = 0; i < world.ducks.count; ++i) {
+        uint32_t bits[2];
+        memcpy(&bits[0], &world.ducks.x[i], 4);
+        memcpy(&bits[1], &world.ducks.y[i], 4);
+        mix(bits[0]);
+        mix(bits[1]);
+    }
+    mix(static_cast<uint32_t>(world.score));
+    mix(static_cast<uint32_t>(world.ducks.stats.spawns));
+    return hash;
+}
@@ -0,0 +1,89 @@
+#pragma once
+#include "duck_pool.h"
+#include "object_pool.h"
+#include "rng.h"
+#include "rules.h"
+
+// Game constants
+const int WINDOW_WIDTH = 800;
+const int WINDOW_HEIGHT = 600;
+const int DUCK_SIZE = 30;
+const int CROSSHAIR_SIZE = 15;
+const int MAX_FLOATING_TEXTS = 32;
+
+// Length of one simulation tick in seconds. Duck velocities are expressed
+// in pixels per tick, so stepWorld() scales them by dt / SIM_STEP.
+const float SIM_STEP = 0.016f;
+
+// One random stream per spawn decision, so changing how one of them is
+// drawn (or how often) leaves the others' sequences alone.
+struct SpawnRandom {
+    Pcg32 side;
+    Pcg32 color;
+    Pcg32 height;
+    Pcg32 velocity;
+};
+
+struct Telemetry;
+
+struct FloatingText {
+    float x, y;
+    float alpha;
+    float speed;
+    int points;
+};
+
+// Everything the game needs to run. The simulation never asks GLUT for the
+// time: World::time is its clock and only moves forward through stepWorld(),
+// so the same World can be driven by the GLUT timer or stepped headless.
+struct World {
+    DuckPool ducks;
+    ObjectPool<FloatingText> floatingTexts;
+    SpawnRandom random;
+    int mode = MODE_CLASSIC;   // GameModeId whose rules apply
+    int maxDucks = ClassicRules::MAX_DUCKS;  // The mode's, or raised by stress runs
+    int spawnsPerTick = ClassicRules::SPAWNS_PER_TICK;  // Likewise
+
+    int score = 0;
+    int timeRemaining = ClassicRules::GAME_DURATION;
+    bool gameOver = false;
+    int missedShots = 0;
+    int totalShots = 0;
+    int shotsRemaining = ClassicRules::SHOTS_PER_ROUND;
+    float duckSpawnTime = 0.0f;
+    bool roundOver = false;
+
+    // Bumped whenever score, missedShots, shotsRemaining, gameOver or
+    // roundOver change, so the HUD knows when its cached copy is stale
+    unsigned int hudVersion = 0;
+
+    // Crosshair position. Only drawn, but kept here so recorded motion
+    // replays through the same path as shots.
+    int pointerX = WINDOW_WIDTH / 2;
+    int pointerY = WINDOW_HEIGHT / 2;
+
+    // Spawns, hits, misses, escapes and round ends are recorded here when
+    // set (see telemetry.h). Copies share it, so only step the original.
+    Telemetry* telemetry = nullptr;
+
+    double time = 0.0;          // Simulation clock in seconds
+    long long tick = 0;         // stepWorld() calls so far; stamps input events
+    float secondAccumulator = 0.0f;  // Time not yet taken off timeRemaining
+};
+
+// Seeds every random stream of the world. The same seed gives the same game
+// on every platform. initWorld() leaves the streams running, so a restart
+// continues the sequence instead of replaying it.
+void seedWorld(World& world, uint64_t seed);
+
+// These run the rules of world.mode through its GameMode entry points.
+void initWorld(World& world);
+void stepWorld(World& world, float dt);
+// A shot with a rewind is tested against the ducks as they were drawn that
+// many ticks before the current one (see findDuckAtPast()).
+void handleShot(World& world, float x, float y, float rewind = 0.0f);
+void addFloatingText(World& world, float x, float y, int points);
+
+// FNV-1a over the bits of the duck positions, score and spawn count. Runs
+// with the same seed and input must give the same value on every platform.
+uint32_t worldChecksum(const World& world);
@@ -0,0 +1,460 @@
+#include "soft_renderer.h"
+#include "background.h"
+#include "duck_mesh.h"
+#include "duck_renderer.h"
+#include "frame.h"
+#include "gl_ext.h"
+#include "hud.h"
+#include "profiler.h"
+#include "shapes.h"
+#include "task_pool.h"
+#include "text_renderer.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define SOFT_SPAN_AVX2
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define SOFT_SPAN_SSE2
+#endif
+
+// Vertices are snapped to 1/256 pixel like GL hardware, and every edge test
+// is exact integer arithmetic on those.
+const int SUBPIXEL_BITS = 8;
+const int SUBPIXEL_ONE = 1 << SUBPIXEL_BITS;
+// Enough bands that work stealing evens out a flock bunched in a few rows
+const int BANDS_PER_THREAD = 4;
+
+// The rows one task owns, in a framebuffer of WINDOW_WIDTH pixels a row
+struct Band {
+    uint32_t* pixels;
+    int y0, y1;
+};
+
+// One edge of a triangle being filled: the column bound floor(n / d) for
+// the current row as q and r, and how much both move per row
+struct EdgeWalk {
+    long long q, r, d;
+    long long stepQ, stepR;
+    int side;   // 1 bounds the span's end, -1 its start, 0 horizontal
+    bool kept;  // Centres exactly on the edge are inside
+};
+
+struct SoftTriangle {
+    float x[3], y[3];
+    float wing[3];
+    int slot;
+};
+
+static std::vector<uint32_t> framebuffer;
+static std::vector<uint32_t> backgroundImage;
+static std::unique_ptr<TaskPool> pool;
+static std::vector<SoftTriangle> duckTriangles;      // Full mesh, then impostor
+static int impostorFirst = 0;
+static int feetFirst[2] = {0, 0};                   // Per mesh, into duckTriangles
+static std::vector<float> detailedDucks;
+static std::vector<float> impostorDucks;
+static std::vector<TextQuad> popupQuads;
+static std::vector<TextQuad> hudQuads;
+static const ShapeList* hudList = nullptr;
+static const unsigned char* atlas = nullptr;
+static int atlasWidth = 0;
+static GLuint presentTexture = 0;
+
+static uint32_t packColor(const float* rgb) {
+    uint32_t color = 0xFF000000u;
+    for (int c = 0; c < 3; ++c) {
+        float v = rgb[c] <= 0.0f ? 0.0f : rgb[c] >= 1.0f ? 1.0f : rgb[c];
+        color |= static_cast<uint32_t>(v * 255.0f + 0.5f) << (8 * c);
+    }
+    return color;
+}
+
+static long long floorDiv(long long a, long long b) {
+    long long q = a / b;
+    return q * b != a && (a < 0) != (b < 0) ? q - 1 : q;
+}
+
+static long long ceilDiv(long long a, long long b) {
+    return -floorDiv(-a, b);
+}
+
+static void fillSpan(uint32_t* row, int x0, int x1, uint32_t color) {
+    int x = x0;
+#if defined(SOFT_SPAN_AVX2)
+    __m256i fill = _mm256_set1_epi32(static_cast<int>(color));
+    for (; x + 8 <= x1; x += 8) {
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(row + x), fill);
+    }
+#elif defined(SOFT_SPAN_SSE2)
+    __m128i fill = _mm_set1_epi32(static_cast<int>(color));
+    for (; x + 4 <= x1; x += 4) {
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(row + x), fill);
+    }
+#endif
+    for (; x < x1; ++x) {
+        row[x] = color;
+    }
+}
+
+// Fills the pixels whose centres lie inside the triangle. A centre exactly
+// on an edge belongs to the triangle to the right of or above that edge
+// (the left and bottom edges are kept, in y-up terms), so triangles sharing
+// an edge never both take or both miss a pixel.
+static void fillTriangle(const Band& band, float ax, float ay, float bx, float by, float cx, float cy, uint32_t color) {
+    long long x[3] = {std::llround(ax * SUBPIXEL_ONE), std::llround(bx * SUBPIXEL_ONE), std::llround(cx * SUBPIXEL_ONE)};
+    long long y[3] = {std::llround(ay * SUBPIXEL_ONE), std::llround(by * SUBPIXEL_ONE), std::llround(cy * SUBPIXEL_ONE)};
+    long long area = (x[1] - x[0]) * (y[2] - y[0]) - (x[2] - x[0]) * (y[1] - y[0]);
+    if (area == 0) {
+        return;
+    }
+    if (area < 0) {
+        std::swap(x[1], x[2]);
+        std::swap(y[1], y[2]);
+    }
+
+    long long minY = std::min(y[0], std::min(y[1], y[2]));
+    long long maxY = std::max(y[0], std::max(y[1], y[2]));
+    const long long half = SUBPIXEL_ONE / 2;
+    int row0 = static_cast<int>(std::max<long long>(band.y0, ceilDiv(minY - half, SUBPIXEL_ONE)));
+    int row1 = static_cast<int>(std::min<long long>(band.y1 - 1, floorDiv(maxY - half, SUBPIXEL_ONE)));
+    if (row0 > row1) {
+        return;
+    }
+
+    // Counter-clockwise, the inside is left of every edge: dx * (Y - y0) -
+    // dy * (X - x0) > 0, or >= 0 on a kept edge. With X = 256 * column + 128
+    // that bounds the column by n / d, which each edge walks down the rows
+    // as a quotient and remainder so no row needs a division.
+    EdgeWalk edges[3];
+    long long firstY = static_cast<long long>(row0) * SUBPIXEL_ONE + half;
+    for (int e = 0; e < 3; ++e) {
+        int next = (e + 1) % 3;
+        long long dx = x[next] - x[e];
+        long long dy = y[next] - y[e];
+        EdgeWalk& edge = edges[e];
+        edge.kept = dy < 0 || (dy == 0 && dx > 0);
+        edge.side = dy > 0 ? 1 : dy < 0 ? -1 : 0;
+        long long c = dx * (firstY - y[e]) + dy * x[e];  // dy * X < c inside
+        long long step = dx * SUBPIXEL_ONE;
+        if (dy == 0) {
+            edge.q = c;
+            edge.stepQ = step;
+            continue;
+        }
+        long long n = dy > 0 ? c - half * dy : half * dy - c;
+        edge.d = SUBPIXEL_ONE * (dy > 0 ? dy : -dy);
+        edge.q = floorDiv(n, edge.d);
+        edge.r = n - edge.q * edge.d;
+        step = dy > 0 ? step : -step;
+        edge.stepQ = floorDiv(step, edge.d);
+        edge.stepR = step - edge.stepQ * edge.d;
+    }
+
+    for (int row = row0; row <= row1; ++row) {
+        long long first = 0, last = WINDOW_WIDTH;  // Pixel columns, last exclusive
+        for (EdgeWalk& edge : edges) {
+            if (edge.side == 0) {
+                if (edge.q < 0 || (edge.q == 0 && !edge.kept)) {
+                    last = first;
+                }
+                edge.q += edge.stepQ;
+                continue;
+            }
+            if (edge.side > 0) {
+                last = std::min(last, edge.kept || edge.r != 0 ? edge.q + 1 : edge.q);
+            } else {
+                first = std::max(first, edge.kept && edge.r == 0 ? edge.q : edge.q + 1);
+            }
+            edge.q += edge.stepQ;
+            edge.r += edge.stepR;
+            if (edge.r >= edge.d) {
+                edge.r -= edge.d;
+                edge.q++;
+            }
+        }
+        if (first < last) {
+            fillSpan(band.pixels + row * WINDOW_WIDTH, static_cast<int>(first), static_cast<int>(last), color);
+        }
+    }
+}
+
+// Lines are filled as GL draws wide aliased lines: the segment widened by
+// the rounded width across its minor axis, a parallelogram whose ends are
+// square to the major axis.
+static void fillLine(const Band& band, float x0, float y0, float x1, float y1, int width, uint32_t color) {
+    float half = width * 0.5f;
+    if (std::fabs(x1 - x0) > std::fabs(y1 - y0)) {
+        fillTriangle(band, x0, y0 - half, x1, y1 - half, x1, y1 + half, color);
+        fillTriangle(band, x0, y0 - half, x1, y1 + half, x0, y0 + half, color);
+    } else {
+        fillTriangle(band, x0 - half, y0, x1 - half, y1, x1 + half, y1, color);
+        fillTriangle(band, x0 - half, y0, x1 + half, y1, x0 + half, y0, color);
+    }
+}
+
+static void fillShapes(const Band& band, const ShapeList& list) {
+    for (const Shape& shape : list.shapes) {
+        const float* p = &list.points[2 * shape.first];
+        uint32_t color = packColor(shape.color);
+        int width = std::max(1, static_cast<int>(shape.lineWidth + 0.5f));
+        switch (shape.kind) {
+        case SHAPE_TRIANGLES:
+            for (int i = 0; i + 2 < shape.count; i += 3) {
+                fillTriangle(band, p[2 * i], p[2 * i + 1], p[2 * i + 2], p[2 * i + 3], p[2 * i + 4], p[2 * i + 5], color);
+            }
+            break;
+        case SHAPE_QUADS:
+            for (int i = 0; i + 3 < shape.count; i += 4) {
+                fillTriangle(band, p[2 * i], p[2 * i + 1], p[2 * i + 2], p[2 * i + 3], p[2 * i + 4], p[2 * i + 5], color);
+                fillTriangle(band, p[2 * i], p[2 * i + 1], p[2 * i + 4], p[2 * i + 5], p[2 * i + 6], p[2 * i + 7], color);
+            }
+            break;
+        case SHAPE_POLYGON:
+            for (int i = 1; i + 1 < shape.count; ++i) {
+                fillTriangle(band, p[0], p[1], p[2 * i], p[2 * i + 1], p[2 * i + 2], p[2 * i + 3], color);
+            }
+            break;
+        case SHAPE_LINES:
+            for (int i = 0; i + 1 < shape.count; i += 2) {
+                fillLine(band, p[2 * i], p[2 * i + 1], p[2 * i + 2], p[2 * i + 3], width, color);
+            }
+            break;
+        case SHAPE_LINE_STRIP:
+        case SHAPE_LINE_LOOP:
+            for (int i = 0; i + 1 < shape.count; ++i) {
+                fillLine(band, p[2 * i], p[2 * i + 1], p[2 * i + 2], p[2 * i + 3], width, color);
+            }
+            if (shape.kind == SHAPE_LINE_LOOP && shape.count > 2) {
+                int last = shape.count - 1;
+                fillLine(band, p[2 * last], p[2 * last + 1], p[0], p[1], width, color);
+            }
+            break;
+        }
+    }
+}
+
+// Glyph coverage times the quad's colour and alpha, blended over the frame
+// as GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA with nearest texel lookup.
+static void blendGlyphs(const Band& band, const std::vector<TextQuad>& quads) {
+    for (const TextQuad& quad : quads) {
+        int row0 = std::max(band.y0, static_cast<int>(std::ceil(quad.y - 0.5f)));
+        int row1 = std::min(band.y1, static_cast<int>(std::ceil(quad.y + quad.height - 0.5f)));
+        int col0 = std::max(0, static_cast<int>(std::ceil(quad.x - 0.5f)));
+        int col1 = std::min(WINDOW_WIDTH, static_cast<int>(std::ceil(quad.x + quad.width - 0.5f)));
+        for (int row = row0; row < row1; ++row) {
+            int texelY = quad.atlasY + static_cast<int>(std::floor(row + 0.5f - quad.y));
+            const unsigned char* coverage = atlas + texelY * atlasWidth + quad.atlasX;
+            uint32_t* out = band.pixels + row * WINDOW_WIDTH;
+            for (int col = col0; col < col1; ++col) {
+                int texelX = static_cast<int>(std::floor(col + 0.5f - quad.x));
+                int a = (quad.color[3] * coverage[texelX] + 127) / 255;
+                if (a == 0) {
+                    continue;
+                }
+                uint32_t dst = out[col];
+                uint32_t blended = 0xFF000000u;
+                for (int c = 0; c < 3; ++c) {
+                    int d = (dst >> (8 * c)) & 0xFF;
+                    blended |= static_cast<uint32_t>((quad.color[c] * a + d * (255 - a) + 127) / 255) << (8 * c);
+                }
+                out[col] = blended;
+            }
+        }
+    }
+}
+
+// Each duck's triangles placed as the instanced vertex shader places them
+static void fillDucks(const Band& band, const std::vector<float>& data, int first, int feet, int end) {
+    float reach = duckMeshReach();
+    for (size_t i = 0; i < data.size(); i += INSTANCE_FLOATS) {
+        const float* duck = &data[i];
+        if (duck[1] + reach < band.y0 || duck[1] - reach > band.y1) {
+            continue;
+        }
+        float wing = duck[2];
+        float facing = duck[3];
+        int color = static_cast<int>(duck[4]);
+        int bodyColor = static_cast<int>(duck[5]);
+        int last = duck[6] > 0.5f ? end : feet;
+
+        for (int t = first; t < last; ++t) {
+            const SoftTriangle& tri = duckTriangles[t];
+            float px[3], py[3];
+            for (int v = 0; v < 3; ++v) {
+                px[v] = tri.x[v] * facing + duck[0];
+                py[v] = tri.y[v] + tri.wing[v] * wing * 0.7f + duck[1];
+            }
+            uint32_t fill = packColor(duckSlotColor(tri.slot, color, bodyColor));
+            fillTriangle(band, px[0], py[0], px[1], py[1], px[2], py[2], fill);
+        }
+    }
+}
+
+static void drawBand(const Band& band) {
+    size_t offset = static_cast<size_t>(band.y0) * WINDOW_WIDTH;
+    memcpy(band.pixels + offset, backgroundImage.data() + offset, (band.y1 - band.y0) * WINDOW_WIDTH * sizeof(uint32_t));
+
+    int meshEnd = static_cast<int>(duckTriangles.size());
+    fillDucks(band, detailedDucks, 0, feetFirst[0], impostorFirst);
+    fillDucks(band, impostorDucks, impostorFirst, feetFirst[1], meshEnd);
+    blendGlyphs(band, popupQuads);
+    if (hudList) {
+        fillShapes(band, *hudList);
+    }
+    blendGlyphs(band, hudQuads);
+}
+
+// forEach() body: band index of the *context bands the screen is split into
+static void drawBandAt(void* context, int index) {
+    int bands = *static_cast<const int*>(context);
+    drawBand({framebuffer.data(), WINDOW_HEIGHT * index / bands, WINDOW_HEIGHT * (index + 1) / bands});
+}
+
+static void addMesh(const std::vector<DuckVertex>& mesh, int& feet) {
+    feet = -1;
+    for (size_t i = 0; i + 2 < mesh.size(); i += 3) {
+        SoftTriangle tri;
+        for (int v = 0; v < 3; ++v) {
+            tri.x[v] = mesh[i + v].x;
+            tri.y[v] = mesh[i + v].y;
+            tri.wing[v] = mesh[i + v].wing;
+        }
+        tri.slot = static_cast<int>(mesh[i].slot);
+        if (tri.slot == DUCK_SLOT_FEET && feet < 0) {
+            feet = static_cast<int>(duckTriangles.size());
+        }
+        duckTriangles.push_back(tri);
+    }
+    if (feet < 0) {
+        feet = static_cast<int>(duckTriangles.size());
+    }
+}
+
+void initSoftRenderer(int threads) {
+    framebuffer.assign(WINDOW_WIDTH * WINDOW_HEIGHT, 0xFF000000u);
+    backgroundImage.assign(WINDOW_WIDTH * WINDOW_HEIGHT, 0xFF000000u);
+    fillShapes({backgroundImage.data(), 0, WINDOW_HEIGHT}, backgroundShapes());
+
+    duckTriangles.clear();
+    addMesh(duckMesh(), feetFirst[0]);
+    impostorFirst = static_cast<int>(duckTriangles.size());
+    addMesh(duckImpostorMesh(), feetFirst[1]);
+
+    pool.reset(threads == 1 ? nullptr : new TaskPool(threads));
+}
+
+void shutdownSoftRenderer() {
+    pool.reset();
+    if (presentTexture) {
+        glDeleteTextures(1, &presentTexture);
+        presentTexture = 0;
+    }
+}
+
+void softDrawScene(const World& world, float alpha) {
+    beginPhase(PHASE_DUCKS);
+    gatherDuckInstances(world.ducks, alpha, WINDOW_HEIGHT, detailedDucks, impostorDucks);
+    endPhase(PHASE_DUCKS);
+
+    // Text is laid out here, on the calling thread; bands only blend it
+    int atlasHeight = 0;
+    atlas = textAtlas(atlasWidth, atlasHeight);
+    popupQuads.clear();
+    hudQuads.clear();
+    beginPhase(PHASE_FLOATING_TEXT);
+    if (atlas) {
+        for (int i = 0; i < world.floatingTexts.size(); ++i) {
+            const FloatingText& ft = world.floatingTexts[i];
+            char text[16];
+            snprintf(text, sizeof(text), "+%d", ft.points);
+            drawText(TEXT_HELVETICA_12, ft.x, ft.y, 1.0f, 1.0f, 0.0f, ft.alpha, text);
+        }
+        takeTextQuads(popupQuads);
+    }
+    endPhase(PHASE_FLOATING_TEXT);
+
+    beginPhase(PHASE_HUD);
+    hudList = &hudShapes(world);
+    if (atlas) {
+        for (const ShapeText& text : hudList->texts) {
+            drawText(text.font, text.x, text.y, text.color[0], text.color[1], text.color[2], text.color[3], text.text);
+        }
+        takeTextQuads(hudQuads);
+    }
+    endPhase(PHASE_HUD);
+
+    // Every layer at once, starting from a copy of the background
+    beginPhase(PHASE_BACKGROUND);
+    if (!pool) {
+        drawBand({framebuffer.data(), 0, WINDOW_HEIGHT});
+    } else {
+        int bands = pool->threads() * BANDS_PER_THREAD;
+        pool->forEach(bands, drawBandAt, &bands);
+    }
+    endPhase(PHASE_BACKGROUND);
+}
+
+void softDrawCrosshair(int x, int y) {
+    static ShapeList crosshair;
+    clearShapes(crosshair);
+    buildCrosshair(x, y, crosshair);
+    fillShapes({framebuffer.data(), 0, WINDOW_HEIGHT}, crosshair);
+}
+
+const uint32_t* softFramebuffer() {
+    return framebuffer.data();
+}
+
+void presentSoftFrame() {
+    // Power-of-two texture, like the background layer, for old GL
+    const int textureWidth = 1024, textureHeight = 1024;
+    if (!presentTexture) {
+        glGenTextures(1, &presentTexture);
+        glBindTexture(GL_TEXTURE_2D, presentTexture);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, textureWidth, textureHeight, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+    }
+    glBindTexture(GL_TEXTURE_2D, presentTexture);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, WINDOW_WIDTH, WINDOW_HEIGHT, GL_RGBA, GL_UNSIGNED_BYTE, framebuffer.data());
+
+    glMatrixMode(GL_PROJECTION);
+    glPushMatrix();
+    glLoadIdentity();
+    glOrtho(0, WINDOW_WIDTH, 0, WINDOW_HEIGHT, -1, 1);
+    glMatrixMode(GL_MODELVIEW);
+    glPushMatrix();
+    glLoadIdentity();
+
+    float u = static_cast<float>(WINDOW_WIDTH) / textureWidth;
+    float v = static_cast<float>(WINDOW_HEIGHT) / textureHeight;
+    glEnable(GL_TEXTURE_2D);
+    glTexEnvi(GL_TEXTURE_ENV, GL_TEXTURE_ENV_MODE, GL_REPLACE);
+    glBegin(GL_QUADS);
+    glTexCoord2f(0.0f, 0.0f);
+    glVertex2f(0, 0);
+    glTexCoord2f(u, 0.0f);
+    glVertex2f(WINDOW_WIDTH, 0);
+    glTexCoord2f(u, v);
+    glVertex2f(WINDOW_WIDTH, WINDOW_HEIGHT);
+    glTexCoord2f(0.0f, v);
+    glVertex2f(0, WINDOW_HEIGHT);
+    glEnd();
+    glBindTexture(GL_TEXTURE_2D, 0);
+    glDisable(GL_TEXTURE_2D);
+
+    glPopMatrix();
+    glMatrixMode(GL_PROJECTION);
+    glPopMatrix();
+    glMatrixMode(GL_MODELVIEW);
+}
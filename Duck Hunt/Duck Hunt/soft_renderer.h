@@ -0,0 +1,27 @@
+#pragma once
+#include "simulation.h"
+#include <cstdint>
+
+// CPU rasterizer for machines whose GL has no hardware behind it. Draws the
+// same frame as frame.h into a WINDOW_WIDTH x WINDOW_HEIGHT framebuffer:
+// the background baked once from its shapes, the duck meshes, the HUD
+// shapes and the glyph atlas text. It follows GL's rasterization rules
+// (pixel centres, 1/256 pixel snapping, one owner for every shared edge)
+// so the output matches the GL path. Spans are filled with SSE2 or AVX2
+// stores, and the frame is cut into bands of rows filled on a TaskPool.
+//
+// Text comes from the glyph atlas, so initTextRenderer() must have built it.
+
+// threads <= 0 uses one per hardware thread; 1 draws on the calling thread.
+void initSoftRenderer(int threads);
+void shutdownSoftRenderer();
+
+void softDrawScene(const World& world, float alpha);
+void softDrawCrosshair(int x, int y);
+
+// The last frame, bottom row first, one RGBA pixel per uint32_t (R in the
+// lowest byte).
+const uint32_t* softFramebuffer();
+
+// Puts the framebuffer up over the current GL viewport as a textured quad.
+void presentSoftFrame();
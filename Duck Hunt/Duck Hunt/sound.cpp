@@ -0,0 +1,248 @@
+#include "sound.h"
+#include "rng.h"
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+
+#ifdef _WIN32
+#include <windows.h>
+#include <mfapi.h>
+#include <mfidl.h>
+#include <mfreadwrite.h>
+#ifdef _MSC_VER
+#pragma comment(lib, "mfplat.lib")
+#pragma comment(lib, "mfreadwrite.lib")
+#pragma comment(lib, "mfuuid.lib")
+#pragma comment(lib, "ole32.lib")
+#endif
+#endif
+
+// Samples as the file had them, before conversion for the mixer
+struct RawAudio {
+    int rate = 0;
+    int channels = 0;
+    std::vector<float> samples;  // Interleaved
+};
+
+static bool readFile(const char* path, std::vector<unsigned char>& bytes) {
+    FILE* file = fopen(path, "rb");
+    if (!file) {
+        return false;
+    }
+    unsigned char buffer[4096];
+    size_t count;
+    while ((count = fread(buffer, 1, sizeof(buffer), file)) > 0) {
+        bytes.insert(bytes.end(), buffer, buffer + count);
+    }
+    bool ok = !ferror(file);
+    fclose(file);
+    return ok;
+}
+
+static unsigned int readLE(const unsigned char* bytes, int count) {
+    unsigned int value = 0;
+    for (int i = 0; i < count; ++i) {
+        value |= static_cast<unsigned int>(bytes[i]) << (8 * i);
+    }
+    return value;
+}
+
+static bool decodeWav(const std::vector<unsigned char>& bytes, RawAudio& audio) {
+    if (bytes.size() < 12 || memcmp(&bytes[0], "RIFF", 4) != 0 || memcmp(&bytes[8], "WAVE", 4) != 0) {
+        return false;
+    }
+
+    int format = 0, bits = 0;
+    const unsigned char* data = nullptr;
+    size_t dataSize = 0;
+    size_t at = 12;
+    while (at + 8 <= bytes.size()) {
+        const unsigned char* chunk = &bytes[at];
+        size_t size = readLE(chunk + 4, 4);
+        if (size > bytes.size() - at - 8) {
+            size = bytes.size() - at - 8;  // Truncated file: take what is there
+        }
+        if (memcmp(chunk, "fmt ", 4) == 0 && size >= 16) {
+            format = readLE(chunk + 8, 2);
+            audio.channels = readLE(chunk + 10, 2);
+            audio.rate = readLE(chunk + 12, 4);
+            bits = readLE(chunk + 22, 2);
+            if (format == 0xFFFE && size >= 40) {
+                format = readLE(chunk + 32, 2);  // WAVE_FORMAT_EXTENSIBLE sub-format
+            }
+        }
+        else if (memcmp(chunk, "data", 4) == 0) {
+            data = chunk + 8;
+            dataSize = size;
+        }
+        at += 8 + size + (size & 1);
+    }
+
+    bool pcm = format == 1 && (bits == 8 || bits == 16 || bits == 24);
+    bool floats = format == 3 && bits == 32;
+    if (!data || audio.channels <= 0 || audio.rate <= 0 || (!pcm && !floats)) {
+        return false;
+    }
+
+    int width = bits / 8;
+    size_t count = dataSize / width;
+    audio.samples.resize(count);
+    for (size_t i = 0; i < count; ++i) {
+        const unsigned char* sample = data + i * width;
+        if (floats) {
+            unsigned int value = readLE(sample, 4);
+            memcpy(&audio.samples[i], &value, 4);
+        }
+        else if (bits == 8) {
+            audio.samples[i] = (sample[0] - 128) / 128.0f;
+        }
+        else {
+            // Sign-extend from the top byte down
+            int value = static_cast<int>(readLE(sample, width) << (32 - bits)) >> (32 - bits);
+            audio.samples[i] = value / static_cast<float>(1 << (bits - 1));
+        }
+    }
+    return true;
+}
+
+#ifdef _WIN32
+// Lets the system codecs do the work: the source reader decodes to 16-bit
+// PCM at the file's own rate and channel count.
+static bool decodeWithMediaFoundation(const char* path, RawAudio& audio) {
+    wchar_t widePath[MAX_PATH];
+    if (MultiByteToWideChar(CP_UTF8, 0, path, -1, widePath, MAX_PATH) == 0) {
+        return false;
+    }
+
+    HRESULT comResult = CoInitializeEx(nullptr, COINIT_MULTITHREADED);
+    if (FAILED(MFStartup(MF_VERSION))) {
+        if (SUCCEEDED(comResult)) {
+            CoUninitialize();
+        }
+        return false;
+    }
+
+    bool ok = false;
+    IMFSourceReader* reader = nullptr;
+    IMFMediaType* request = nullptr;
+    IMFMediaType* actual = nullptr;
+    if (SUCCEEDED(MFCreateSourceReaderFromURL(widePath, nullptr, &reader))
+        && SUCCEEDED(MFCreateMediaType(&request))
+        && SUCCEEDED(request->SetGUID(MF_MT_MAJOR_TYPE, MFMediaType_Audio))
+        && SUCCEEDED(request->SetGUID(MF_MT_SUBTYPE, MFAudioFormat_PCM))
+        && SUCCEEDED(request->SetUINT32(MF_MT_AUDIO_BITS_PER_SAMPLE, 16))
+        && SUCCEEDED(reader->SetCurrentMediaType(MF_SOURCE_READER_FIRST_AUDIO_STREAM, nullptr, request))
+        && SUCCEEDED(reader->GetCurrentMediaType(MF_SOURCE_READER_FIRST_AUDIO_STREAM, &actual))) {
+        audio.channels = MFGetAttributeUINT32(actual, MF_MT_AUDIO_NUM_CHANNELS, 0);
+        audio.rate = MFGetAttributeUINT32(actual, MF_MT_AUDIO_SAMPLES_PER_SECOND, 0);
+        ok = audio.channels > 0 && audio.rate > 0;
+
+        while (ok) {
+            DWORD flags = 0;
+            IMFSample* sample = nullptr;
+            if (FAILED(reader->ReadSample(MF_SOURCE_READER_FIRST_AUDIO_STREAM, 0, nullptr, &flags, nullptr, &sample))) {
+                ok = false;
+                break;
+            }
+            if (sample) {
+                IMFMediaBuffer* buffer = nullptr;
+                BYTE* bytes = nullptr;
+                DWORD length = 0;
+                if (SUCCEEDED(sample->ConvertToContiguousBuffer(&buffer)) && SUCCEEDED(buffer->Lock(&bytes, nullptr, &length))) {
+                    for (DWORD i = 0; i + 1 < length; i += 2) {
+                        short value = static_cast<short>(readLE(bytes + i, 2));
+                        audio.samples.push_back(value / 32768.0f);
+                    }
+                    buffer->Unlock();
+                }
+                else {
+                    ok = false;
+                }
+                if (buffer) {
+                    buffer->Release();
+                }
+                sample->Release();
+            }
+            if (flags & MF_SOURCE_READERF_ENDOFSTREAM) {
+                break;
+            }
+        }
+    }
+
+    if (actual) actual->Release();
+    if (request) request->Release();
+    if (reader) reader->Release();
+    MFShutdown();
+    if (SUCCEEDED(comResult)) {
+        CoUninitialize();
+    }
+    return ok && !audio.samples.empty();
+}
+#endif
+
+// Linear resampling is plenty for a one-off conversion of sound effects
+static void convertForMixer(const RawAudio& audio, int rate, Sound& sound) {
+    int inFrames = static_cast<int>(audio.samples.size() / audio.channels);
+    int outFrames = static_cast<int>(static_cast<long long>(inFrames) * rate / audio.rate);
+    double step = static_cast<double>(audio.rate) / rate;
+
+    sound.rate = rate;
+    sound.samples.assign(2 * static_cast<size_t>(outFrames), 0.0f);
+    for (int frame = 0; frame < outFrames; ++frame) {
+        double position = frame * step;
+        int index = static_cast<int>(position);
+        int next = index + 1 < inFrames ? index + 1 : index;
+        float t = static_cast<float>(position - index);
+        for (int channel = 0; channel < 2; ++channel) {
+            // Mono goes to both sides; past stereo only the front pair plays
+            int source = channel < audio.channels ? channel : 0;
+            float a = audio.samples[index * audio.channels + source];
+            float b = audio.samples[next * audio.channels + source];
+            sound.samples[2 * frame + channel] = a + (b - a) * t;
+        }
+    }
+}
+
+bool loadSound(const char* path, int rate, Sound& sound) {
+    std::vector<unsigned char> bytes;
+    if (!readFile(path, bytes)) {
+        fprintf(stderr, "Cannot read %s\n", path);
+        return false;
+    }
+
+    RawAudio audio;
+    bool decoded = decodeWav(bytes, audio);
+#ifdef _WIN32
+    if (!decoded) {
+        audio = RawAudio();
+        decoded = decodeWithMediaFoundation(path, audio);
+    }
+#endif
+    if (!decoded) {
+        fprintf(stderr, "Cannot decode %s: not a PCM WAV file, and no system decoder for other formats here\n", path);
+        return false;
+    }
+
+    convertForMixer(audio, rate, sound);
+    return true;
+}
+
+void synthesizeGunshot(int rate, Sound& sound) {
+    Pcg32 noise;
+    seedRandom(noise, 1, 1);
+
+    int frames = rate * 3 / 10;
+    sound.rate = rate;
+    sound.samples.resize(2 * static_cast<size_t>(frames));
+    float lowPass = 0.0f;
+    for (int frame = 0; frame < frames; ++frame) {
+        float t = static_cast<float>(frame) / rate;
+        float white = 2.0f * randomFloat(noise) - 1.0f;
+        lowPass += 0.25f * (white - lowPass);
+        float crack = lowPass * std::exp(-t * 30.0f);
+        float thump = std::sin(2.0f * 3.14159265f * 70.0f * t) * std::exp(-t * 18.0f);
+        float value = 0.7f * crack + 0.5f * thump;
+        sound.samples[2 * frame] = value;
+        sound.samples[2 * frame + 1] = value;
+    }
+}
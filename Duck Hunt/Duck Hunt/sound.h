@@ -0,0 +1,23 @@
+#pragma once
+#include <vector>
+
+// Decoded audio ready for the mixer: interleaved stereo floats in [-1, 1]
+// at the mixer's sample rate, so playing it is a straight copy.
+struct Sound {
+    int rate = 0;
+    std::vector<float> samples;  // Left, right, left, right...
+};
+
+inline int soundFrames(const Sound& sound) {
+    return static_cast<int>(sound.samples.size() / 2);
+}
+
+// Decodes a sound file and converts it to stereo at rate. WAV files (8, 16
+// or 24-bit PCM, 32-bit float) load everywhere. On Windows anything Media
+// Foundation can decode loads too, MP3 included. Returns false and prints
+// the reason on failure.
+bool loadSound(const char* path, int rate, Sound& sound);
+
+// A short decaying noise burst over a low thump, used when the real asset
+// cannot be decoded on this platform. The same every time.
+void synthesizeGunshot(int rate, Sound& sound);
@@ -1,758 +1,527 @@
-#define _USE_MATH_DEFINES
 #include <GL/glut.h>
 #include <cstdlib>
 #include <ctime>
 #include <vector>
 #include <iostream>
-#include <string>
 #include <cmath>
-
-
-#ifndef M_PI
-#define M_PI 3.14159265358979323846
+#include <cstdio>
+#include <cstring>
+#include <chrono>
+#include <thread>
+#include "simulation.h"
+#include "duck_renderer.h"
+#include "background.h"
+#include "text_renderer.h"
+#include "hud.h"
+#include "frame.h"
+#include "game_loop.h"
+#include "profiler.h"
+#include "replay.h"
+#include "audio.h"
+#include "pointer_input.h"
+#include "soft_renderer.h"
+#include "sim_thread.h"
+#include "telemetry.h"
+
+#ifdef FREEGLUT
+#include <GL/freeglut_ext.h>
+#endif
+#ifdef DUCKHUNT_X11
+#include <GL/glx.h>
 #endif
 
-// Game constants
-const int WINDOW_WIDTH = 800;
-const int WINDOW_HEIGHT = 600;
-const int MAX_DUCKS = 3;
-const float DUCK_SPEED = 3.0f;
-const int DUCK_SIZE = 30;
-const int SHOT_RADIUS = 20;
-const int GAME_DURATION = 60;
-const int CROSSHAIR_SIZE = 15;
-const int SHOTS_PER_ROUND = 10;
-const int BASE_POINTS = 500;
-const int BONUS_POINTS = 500;
-const float MAX_BONUS_TIME = 2.0f;
-
-// Game state
-int score = 0;
-int timeRemaining = GAME_DURATION;
-bool gameOver = false;
-int lastTime = 0;
-int missedShots = 0;
-int totalShots = 0;
-int mouseX = WINDOW_WIDTH / 2;
-int mouseY = WINDOW_HEIGHT / 2;
-int shotsRemaining = SHOTS_PER_ROUND;
-float duckSpawnTime = 0.0f;
-bool roundOver = false;
-
-// Duck struct
-struct Duck {
-    float x, y;
-    float dx, dy;
-    bool active;
-    int color;
-    float wingAngle;
-    float wingDir;
-    int bodyColor;
-};
-
-struct FloatingText {
-    float x, y;
-    float alpha;
-    float speed;
-    std::string text;
-};
-
-std::vector<Duck> ducks;
-std::vector<FloatingText> floatingTexts;
-
-const float duckColors[][3] = {
-    {1.0f, 1.0f, 0.0f}, // Yellow duck
-    {0.2f, 0.8f, 0.2f}  // Green duck (wings, head)
-};
 
-const float duckBodyColors[][3] = {
-    {1.0f, 1.0f, 0.0f}, // Yellow duck body 
-    {1.0f, 1.0f, 1.0f}  // White body for green duck
-};
+SimThread sim;       // Owns the World
+GameLoop gameLoop;   // Frame pacing; the ticks run in sim.loop
+bool showProfiler = false;
+const char* profileCsvPath = nullptr;  // Only written when asked for
+uint64_t seed = static_cast<uint64_t>(time(nullptr));
+InputLog inputLog;
+const char* recordPath = nullptr;
+const char* replayPath = nullptr;
+Bot bot;
+bool botPlaying = false;
+AudioConfig audioConfig;
+const char* soundPath = nullptr;
+Sound gunshot;
+bool audioEnabled = true;
+PointerInput pointerInput;
+int renderer = RENDER_GL;  // RenderBackendId
+int renderThreads = 0;
+double shownTick = -1.0;  // Simulation time of the frame on screen, in ticks
+Telemetry telemetry;
+TelemetryConfig telemetryConfig;
+bool telemetryEnabled = false;
 
 void display();
 void reshape(int w, int h);
-void timer(int value);
+void idle();
+void keyboard(unsigned char key, int x, int y);
 void mouseClick(int button, int state, int x, int y);
 void passiveMouseMotion(int x, int y);
-void initGame();
-void spawnDuck();
-void drawDuck(const Duck& duck);
-void drawHUD();
-void drawBackground();
-void drawCrosshair();
-void updateAndDrawFloatingTexts();
-void addFloatingText(float x, float y, int points);
 int getDigitCount(int number);
 
-int main(int argc, char** argv) {
-    srand(static_cast<unsigned int>(time(nullptr)));
-    glutInit(&argc, argv);
-    glutInitDisplayMode(GLUT_DOUBLE | GLUT_RGB);
-    glutInitWindowSize(WINDOW_WIDTH, WINDOW_HEIGHT);
-    glutCreateWindow("Duck Hunt Clone");
+static GlProc lookupGlProc(const char* name) {
+#if defined(_WIN32)
+    return reinterpret_cast<GlProc>(wglGetProcAddress(name));
+#elif defined(FREEGLUT)
+    return glutGetProcAddress(name);
+#else
+    return nullptr;
+#endif
+}
 
-    glutDisplayFunc(display);
-    glutReshapeFunc(reshape);
-    glutTimerFunc(1000, timer, 0);
-    glutMouseFunc(mouseClick);
-    glutPassiveMotionFunc(passiveMouseMotion);
-    glutSetCursor(GLUT_CURSOR_NONE);
+static void* const glutFonts[TEXT_FONT_COUNT] = {
+    GLUT_BITMAP_HELVETICA_12,
+    GLUT_BITMAP_HELVETICA_18,
+    GLUT_BITMAP_9_BY_15
+};
 
-    initGame();
-    glutMainLoop();
-    return 0;
+static void drawGlutGlyph(int font, char c) {
+    glutBitmapCharacter(glutFonts[font], c);
 }
 
-int getDigitCount(int number) {
-    if (number == 0) return 1;
-    int count = 0;
-    while (number > 0) {
-        number /= 10;
-        count++;
-    }
-    return count;
+static int glutGlyphAdvance(int font, char c) {
+    return glutBitmapWidth(glutFonts[font], c);
 }
 
-void passiveMouseMotion(int x, int y) {
-    mouseX = x;
-    mouseY = WINDOW_HEIGHT - y;
-    glutPostRedisplay();
+static int glutLineHeight(int font) {
+    return font == TEXT_HELVETICA_18 ? 22 : 15;
 }
 
-void drawCrosshair() {
-    glMatrixMode(GL_PROJECTION);
-    glPushMatrix();
-    glLoadIdentity();
-    gluOrtho2D(0, WINDOW_WIDTH, 0, WINDOW_HEIGHT);
-    glMatrixMode(GL_MODELVIEW);
-    glPushMatrix();
-    glLoadIdentity();
+static const GlyphSource glutGlyphSource = {drawGlutGlyph, glutGlyphAdvance, glutLineHeight};
 
-    glColor3f(1.0f, 0.0f, 0.0f);
-    glLineWidth(2.0f);
+static double secondsNow() {
+    using namespace std::chrono;
+    return duration<double>(steady_clock::now().time_since_epoch()).count();
+}
 
-    glBegin(GL_LINES);
-    glVertex2f(mouseX - CROSSHAIR_SIZE, mouseY);
-    glVertex2f(mouseX + CROSSHAIR_SIZE, mouseY);
-    glVertex2f(mouseX, mouseY - CROSSHAIR_SIZE);
-    glVertex2f(mouseX, mouseY + CROSSHAIR_SIZE);
-    glEnd();
+// Returns false when the driver offers no way to change the swap interval.
+static bool setSwapInterval(int interval) {
+#if defined(_WIN32)
+    typedef BOOL (WINAPI* SwapIntervalProc)(int);
+    SwapIntervalProc swapInterval = reinterpret_cast<SwapIntervalProc>(lookupGlProc("wglSwapIntervalEXT"));
+    return swapInterval && swapInterval(interval);
+#else
+    // GLX_SGI_swap_control is the widely supported one but cannot turn
+    // vsync off; GLX_MESA_swap_control can
+    typedef int (*SwapIntervalProc)(int);
+    const char* name = interval > 0 ? "glXSwapIntervalSGI" : "glXSwapIntervalMESA";
+    SwapIntervalProc swapInterval = reinterpret_cast<SwapIntervalProc>(lookupGlProc(name));
+    return swapInterval && swapInterval(interval) == 0;
+#endif
+}
 
-    glBegin(GL_LINE_LOOP);
-    float radius = CROSSHAIR_SIZE / 3.0f;
-    for (int i = 0; i < 16; i++) {
-        float angle = 2.0f * M_PI * i / 16;
-        glVertex2f(mouseX + radius * cos(angle), mouseY + radius * sin(angle));
+// Options left over after glutInit: --vsync (default), --fps N, --uncapped,
+// --profile-csv PATH, --seed N, --record PATH, --replay PATH, --bot,
+// --mode classic|swarm|sniper|stress, --ducks N, --spawn-rate N,
+// --audio device|null|off, --audio-wav PATH, --sound PATH,
+// --renderer gl|soft, --render-threads N, --telemetry PATH
+static void parseOptions(int argc, char** argv) {
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "--vsync") == 0) {
+            gameLoop.pacing = FRAME_VSYNC;
+        }
+        else if (strcmp(argv[i], "--fps") == 0 && i + 1 < argc) {
+            int fps = atoi(argv[++i]);
+            if (fps > 0) {
+                gameLoop.pacing = FRAME_CAPPED;
+                gameLoop.frameInterval = 1.0 / fps;
+            }
+        }
+        else if (strcmp(argv[i], "--uncapped") == 0) {
+            gameLoop.pacing = FRAME_UNCAPPED;
+        }
+        else if (strcmp(argv[i], "--profile-csv") == 0 && i + 1 < argc) {
+            profileCsvPath = argv[++i];
+        }
+        else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc) {
+            seed = strtoull(argv[++i], nullptr, 10);
+        }
+        else if (strcmp(argv[i], "--record") == 0 && i + 1 < argc) {
+            recordPath = argv[++i];
+        }
+        else if (strcmp(argv[i], "--replay") == 0 && i + 1 < argc) {
+            replayPath = argv[++i];
+        }
+        else if (strcmp(argv[i], "--bot") == 0) {
+            botPlaying = true;
+        }
+        else if (strcmp(argv[i], "--ducks") == 0 && i + 1 < argc) {
+            inputLog.maxDucks = atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--spawn-rate") == 0 && i + 1 < argc) {
+            inputLog.spawnsPerTick = atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--audio") == 0 && i + 1 < argc) {
+            ++i;
+            audioConfig.output = strcmp(argv[i], "null") == 0 ? AUDIO_NULL : AUDIO_DEVICE;
+            audioEnabled = strcmp(argv[i], "off") != 0;
+        }
+        else if (strcmp(argv[i], "--audio-wav") == 0 && i + 1 < argc) {
+            audioConfig.output = AUDIO_WAV_FILE;
+            audioConfig.wavPath = argv[++i];
+        }
+        else if (strcmp(argv[i], "--sound") == 0 && i + 1 < argc) {
+            soundPath = argv[++i];
+        }
+        else if (strcmp(argv[i], "--mode") == 0 && i + 1 < argc) {
+            int mode = findGameMode(argv[++i]);
+            if (mode != -1) {
+                inputLog.mode = mode;
+            }
+            else {
+                std::cout << "Unknown mode " << argv[i] << ", playing classic" << std::endl;
+            }
+        }
+        else if (strcmp(argv[i], "--renderer") == 0 && i + 1 < argc) {
+            int backend = findRenderBackend(argv[++i]);
+            if (backend != -1) {
+                renderer = backend;
+            }
+            else {
+                std::cout << "Unknown renderer " << argv[i] << ", drawing with gl" << std::endl;
+            }
+        }
+        else if (strcmp(argv[i], "--render-threads") == 0 && i + 1 < argc) {
+            renderThreads = atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--telemetry") == 0 && i + 1 < argc) {
+            telemetryConfig.path = argv[++i];
+            telemetryEnabled = true;
+        }
     }
-    glEnd();
-
-    glPopMatrix();
-    glMatrixMode(GL_PROJECTION);
-    glPopMatrix();
-    glMatrixMode(GL_MODELVIEW);
 }
 
-void initGame() {
-    ducks.clear();
-    floatingTexts.clear();
-    score = 0;
-    timeRemaining = GAME_DURATION;
-    gameOver = false;
-    missedShots = 0;
-    totalShots = 0;
-    shotsRemaining = SHOTS_PER_ROUND;
-    roundOver = false;
-    lastTime = glutGet(GLUT_ELAPSED_TIME);
-
-    for (int i = 0; i < MAX_DUCKS; ++i) {
-        spawnDuck();
+// GLUT exits from inside glutMainLoop when the window closes
+static void printRenderStats() {
+    stopSimThread(sim);
+    stopTelemetry(telemetry);
+    SimStats simulation = simStats(sim);
+    std::cout << "Simulated " << sim.loop.steps << " ticks, drew " << gameLoop.frames << " frames, skipped "
+              << gameLoop.skippedPasses << " idle passes" << std::endl;
+    printf("Simulation thread: %lld passes, %lld caught up on missed ticks, woke %.2f ms late on average, %.2f ms at worst\n",
+        simulation.passes, simulation.catchUpPasses, simulation.meanLateMs, simulation.maxLateMs);
+    if (simulation.inputDropped > 0) {
+        std::cout << "Dropped " << simulation.inputDropped << " input events on a full queue" << std::endl;
+    }
+    if (telemetryEnabled) {
+        TelemetryStats events = telemetryStats(telemetry);
+        printf("Telemetry: %lld events, %lld dropped, %lld written to %d files under %s%s\n", events.recorded,
+            events.dropped, events.written, events.files, telemetryConfig.path, events.failed ? ", writing failed" : "");
+    }
+    HudCacheStats hud = hudCacheStats();
+    std::cout << "HUD rebuilt " << hud.rebuilds << " times, reused for " << hud.reusedFrames << " frames" << std::endl;
+    const DuckDrawStats& ducks = duckDrawStats();
+    std::cout << "Last frame drew " << ducks.detailed << " detailed ducks and " << ducks.impostors << " impostors in "
+              << ducks.drawCalls << " draw calls, culled " << ducks.culled << std::endl;
+    if (pointerInput.received > 0) {
+        SampleStats freshest = sampleStats(pointerInput.freshest);
+        SampleStats oldest = sampleStats(pointerInput.oldest);
+        printf("Pointer: %lld samples, %.0f/s lately; input to swap over the last %d frames with new input:\n",
+            pointerInput.received, pointerSampleRate(pointerInput), freshest.samples);
+        printf("  newest sample  mean %.2f ms, p50 %.2f, p99 %.2f, max %.2f\n", freshest.mean, freshest.p50, freshest.p99, freshest.max);
+        printf("  oldest sample  mean %.2f ms, p50 %.2f, p99 %.2f, max %.2f\n", oldest.mean, oldest.p50, oldest.p99, oldest.max);
+    }
+    if (profileCsvPath) {
+        if (writeProfileCsv(profileCsvPath)) {
+            std::cout << "Frame profile written to " << profileCsvPath << std::endl;
+        }
+        else {
+            std::cout << "Cannot write frame profile " << profileCsvPath << std::endl;
+        }
+    }
+    if (recordPath) {
+        finishRecording(inputLog, sim.world);
+        if (writeInputLog(recordPath, inputLog)) {
+            std::cout << "Recorded " << inputLog.events.size() << " input events to " << recordPath << std::endl;
+        }
+        else {
+            std::cout << "Cannot write replay log " << recordPath << std::endl;
+        }
     }
 }
 
-void spawnDuck() {
-    Duck duck;
-    duck.active = true;
-    duck.color = rand() % 2;
-    duck.bodyColor = duck.color; // Default to matching body color
-
-    // For green ducks (color index 1), use the white body color
-    if (duck.color == 1) {
-        duck.bodyColor = 1; // Use white body for green ducks
+static void stopGameAudio() {
+    stopAudio();
+    AudioStats stats = audioStats();
+    std::cout << "Played " << stats.voicesStarted << " gunshots, " << stats.commandsDropped << " dropped, "
+              << stats.voicesStolen << " cut short; click to mix " << stats.latencyMeanMs << " ms mean, "
+              << stats.latencyMaxMs << " ms worst, plus " << stats.deviceLatencyMs << " ms device buffering" << std::endl;
+    if (audioConfig.output == AUDIO_WAV_FILE) {
+        std::cout << "Audio written to " << audioConfig.wavPath << std::endl;
     }
+}
 
-    if (rand() % 2 == 0) {
-        duck.x = -DUCK_SIZE;
-        duck.dx = DUCK_SPEED * (0.5f + static_cast<float>(rand()) / RAND_MAX);
+// Decodes the gunshot once, up front, so a click only has to queue it
+static void startGameAudio() {
+    const char* candidates[] = {"gunshot.mp3", "../gunshot.mp3", "Duck Hunt/gunshot.mp3"};
+    bool loaded = false;
+    if (soundPath) {
+        loaded = loadSound(soundPath, audioConfig.rate, gunshot);
     }
     else {
-        duck.x = WINDOW_WIDTH + DUCK_SIZE;
-        duck.dx = -DUCK_SPEED * (0.5f + static_cast<float>(rand()) / RAND_MAX);
+        for (const char* path : candidates) {
+            FILE* file = fopen(path, "rb");
+            if (file) {
+                fclose(file);
+                loaded = loadSound(path, audioConfig.rate, gunshot);
+                break;
+            }
+        }
     }
-
-    duck.y = WINDOW_HEIGHT / 2 + (WINDOW_HEIGHT / 3) * static_cast<float>(rand()) / RAND_MAX;
-    duck.dy = DUCK_SPEED * 0.5f * (static_cast<float>(rand()) / RAND_MAX - 0.5f);
-    duck.wingAngle = DUCK_SIZE * 0.8f;
-    duck.wingDir = -1.0f;
-
-    if (ducks.empty()) {
-        duckSpawnTime = glutGet(GLUT_ELAPSED_TIME) / 1000.0f;
+    if (!loaded) {
+        std::cout << "Using a synthesized gunshot" << std::endl;
+        synthesizeGunshot(audioConfig.rate, gunshot);
     }
 
-    ducks.push_back(duck);
+    if (startAudio(audioConfig, &gunshot, 1)) {
+        atexit(stopGameAudio);
+    }
+    else {
+        std::cout << "Cannot start audio, playing silently" << std::endl;
+    }
 }
 
-void drawDuck(const Duck& duck) {
-    glPushMatrix();
-    glTranslatef(duck.x, duck.y, 0.0f);
-
-    if (duck.dx < 0) {
-        glScalef(-1.0f, 1.0f, 1.0f);
-    }
-
-    // Draw the beak with the main color
-    glColor3fv(duckColors[duck.color]);
-    glBegin(GL_TRIANGLES);
-    glVertex2f(-DUCK_SIZE * 0.9f, -DUCK_SIZE * 0.2f);
-    glVertex2f(-DUCK_SIZE * 1.2f, 0.0f);
-    glVertex2f(-DUCK_SIZE * 0.9f, DUCK_SIZE * 0.2f);
-    glEnd();
-
-    // Draw the body with the body color
-    // For green ducks, this will be white
-    glColor3fv(duckBodyColors[duck.bodyColor]);
-    glBegin(GL_POLYGON);
-    float bodyRadius = DUCK_SIZE * 0.8f;
-    float bodyHeight = DUCK_SIZE * 0.6f;
-    for (int i = 0; i < 20; i++) {
-        float angle = 2.0f * M_PI * i / 20;
-        glVertex2f(bodyRadius * 0.8f * cos(angle), bodyHeight * sin(angle));
-    }
-    glEnd();
-
-    // Draw the neck with the body color too
-    glBegin(GL_QUADS);
-    glVertex2f(DUCK_SIZE * 0.5f, -DUCK_SIZE * 0.1f);
-    glVertex2f(DUCK_SIZE * 0.7f, -DUCK_SIZE * 0.1f);
-    glVertex2f(DUCK_SIZE * 0.7f, DUCK_SIZE * 0.3f);
-    glVertex2f(DUCK_SIZE * 0.5f, DUCK_SIZE * 0.3f);
-    glEnd();
-
-    // Head uses the main color
-    glColor3fv(duckColors[duck.color]);
-    glBegin(GL_POLYGON);
-    float headX = DUCK_SIZE * 0.85f;
-    float headY = DUCK_SIZE * 0.4f;
-    float headRadius = DUCK_SIZE * 0.3f;
-    for (int i = 0; i < 16; i++) {
-        float angle = 2.0f * M_PI * i / 16;
-        glVertex2f(headX + headRadius * cos(angle), headY + headRadius * sin(angle));
-    }
-    glEnd();
-
-    glColor3f(1.0f, 0.5f, 0.0f);
-    glBegin(GL_TRIANGLES);
-    glVertex2f(DUCK_SIZE * 1.1f, DUCK_SIZE * 0.3f);
-    glVertex2f(DUCK_SIZE * 1.5f, DUCK_SIZE * 0.4f);
-    glVertex2f(DUCK_SIZE * 1.1f, DUCK_SIZE * 0.5f);
-    glEnd();
-
-    glColor3f(1.0f, 1.0f, 1.0f);
-    glBegin(GL_POLYGON);
-    float eyeX = DUCK_SIZE * 1.0f;
-    float eyeY = DUCK_SIZE * 0.5f;
-    float eyeRadius = DUCK_SIZE * 0.1f;
-    for (int i = 0; i < 12; i++) {
-        float angle = 2.0f * M_PI * i / 12;
-        glVertex2f(eyeX + eyeRadius * cos(angle), eyeY + eyeRadius * sin(angle));
-    }
-    glEnd();
-
-    glColor3f(0.0f, 0.0f, 0.0f);
-    glBegin(GL_POLYGON);
-    float pupilRadius = DUCK_SIZE * 0.05f;
-    for (int i = 0; i < 8; i++) {
-        float angle = 2.0f * M_PI * i / 8;
-        glVertex2f(eyeX + pupilRadius * cos(angle), eyeY + pupilRadius * sin(angle));
-    }
-    glEnd();
-
-    // Wings use the main color
-    glColor3fv(duckColors[duck.color]);
-    glBegin(GL_POLYGON);
-    float wingAngle = duck.wingAngle * 0.7f;
-    float wingTipX = -DUCK_SIZE * 0.2f;
-    float wingTipY = DUCK_SIZE * 0.3f + wingAngle;
-    glVertex2f(-DUCK_SIZE * 0.1f, DUCK_SIZE * 0.1f);
-    glVertex2f(-DUCK_SIZE * 0.5f, DUCK_SIZE * 0.2f + wingAngle * 0.5f);
-    glVertex2f(wingTipX, wingTipY);
-    glVertex2f(-DUCK_SIZE * 0.3f, DUCK_SIZE * 0.1f + wingAngle * 0.3f);
-    glVertex2f(DUCK_SIZE * 0.1f, DUCK_SIZE * 0.1f);
-    glEnd();
-
-    glBegin(GL_POLYGON);
-    float wingAngle2 = -wingAngle * 0.8f;
-    float wingTipX2 = -DUCK_SIZE * 0.2f;
-    float wingTipY2 = -DUCK_SIZE * 0.1f + wingAngle2;
-    glVertex2f(-DUCK_SIZE * 0.1f, -DUCK_SIZE * 0.1f);
-    glVertex2f(-DUCK_SIZE * 0.4f, -DUCK_SIZE * 0.1f + wingAngle2 * 0.5f);
-    glVertex2f(wingTipX2, wingTipY2);
-    glVertex2f(-DUCK_SIZE * 0.3f, -DUCK_SIZE * 0.1f + wingAngle2 * 0.3f);
-    glVertex2f(DUCK_SIZE * 0.1f, -DUCK_SIZE * 0.1f);
-    glEnd();
-
-    if (fabs(duck.dy) < fabs(duck.dx) * 0.5f) {
-        glColor3f(1.0f, 0.5f, 0.0f);
-        glBegin(GL_TRIANGLES);
-        glVertex2f(-DUCK_SIZE * 0.1f, -DUCK_SIZE * 0.5f);
-        glVertex2f(-DUCK_SIZE * 0.3f, -DUCK_SIZE * 0.7f);
-        glVertex2f(DUCK_SIZE * 0.1f, -DUCK_SIZE * 0.7f);
-        glVertex2f(DUCK_SIZE * 0.3f, -DUCK_SIZE * 0.5f);
-        glVertex2f(DUCK_SIZE * 0.1f, -DUCK_SIZE * 0.7f);
-        glVertex2f(DUCK_SIZE * 0.5f, -DUCK_SIZE * 0.7f);
-        glEnd();
-    }
-
-    glPopMatrix();
-}
+int main(int argc, char** argv) {
+    glutInit(&argc, argv);
+    glutInitDisplayMode(GLUT_DOUBLE | GLUT_RGB);
+    glutInitWindowSize(WINDOW_WIDTH, WINDOW_HEIGHT);
+    glutCreateWindow("Duck Hunt Clone");
+    parseOptions(argc, argv);
 
-void drawBackground() {
-    // Sky
-    glBegin(GL_QUADS);
-    glColor3f(0.5f, 0.8f, 1.0f);
-    glVertex2f(0, 0);
-    glVertex2f(WINDOW_WIDTH, 0);
-    glVertex2f(WINDOW_WIDTH, WINDOW_HEIGHT);
-    glVertex2f(0, WINDOW_HEIGHT);
-    glEnd();
-
-    // Sky grid lines
-    glColor3f(0.6f, 0.85f, 1.0f);
-    glLineWidth(0.5f);
-    glBegin(GL_LINES);
-    for (int i = 0; i < WINDOW_WIDTH; i += 40) {
-        glVertex2f(i, WINDOW_HEIGHT / 5);
-        glVertex2f(i, WINDOW_HEIGHT);
-    }
-    for (int i = WINDOW_HEIGHT / 5; i < WINDOW_HEIGHT; i += 40) {
-        glVertex2f(0, i);
-        glVertex2f(WINDOW_WIDTH, i);
-    }
-    glEnd();
-
-    // Sand/ground
-    glBegin(GL_QUADS);
-    glColor3f(0.9f, 0.9f, 0.0f);
-    glVertex2f(0, WINDOW_HEIGHT / 5);
-    glVertex2f(WINDOW_WIDTH, WINDOW_HEIGHT / 5);
-    glVertex2f(WINDOW_WIDTH, WINDOW_HEIGHT / 3.5);
-    glVertex2f(0, WINDOW_HEIGHT / 3.5);
-    glEnd();
-
-    // Grass tufts on sand
-    glColor3f(0.7f, 0.8f, 0.0f);
-    for (int i = 10; i < WINDOW_WIDTH; i += 30) {
-        glBegin(GL_TRIANGLES);
-        glVertex2f(i, WINDOW_HEIGHT / 3.5);
-        glVertex2f(i + 5, WINDOW_HEIGHT / 3.2);
-        glVertex2f(i + 10, WINDOW_HEIGHT / 3.5);
-        glEnd();
-    }
-
-    // Dirt/ground
-    glBegin(GL_QUADS);
-    glColor3f(0.6f, 0.3f, 0.0f);
-    glVertex2f(0, 0);
-    glVertex2f(WINDOW_WIDTH, 0);
-    glVertex2f(WINDOW_WIDTH, WINDOW_HEIGHT / 5);
-    glVertex2f(0, WINDOW_HEIGHT / 5);
-    glEnd();
-
-    // Tree trunk - Draw as a single rectangle that extends up to the leaves
-    glColor3f(0.8f, 0.2f, 0.0f);
-    glBegin(GL_QUADS);
-    glVertex2f(120, WINDOW_HEIGHT / 3.5);  // Start at ground level
-    glVertex2f(140, WINDOW_HEIGHT / 3.5);
-    glVertex2f(140, WINDOW_HEIGHT / 1.6);  // Extend higher to connect with leaves
-    glVertex2f(120, WINDOW_HEIGHT / 1.6);
-    glEnd();
-
-    // Tree branch
-    glBegin(GL_QUADS);
-    glVertex2f(140, WINDOW_HEIGHT / 1.7);
-    glVertex2f(180, WINDOW_HEIGHT / 1.7);
-    glVertex2f(180, WINDOW_HEIGHT / 1.6);
-    glVertex2f(140, WINDOW_HEIGHT / 1.6);
-    glEnd();
-
-    // Tree leaves (four green circles)
-    glColor3f(0.7f, 0.9f, 0.0f);
-    for (int cx = 0; cx < 2; cx++) {
-        for (int cy = 0; cy < 2; cy++) {
-            glBegin(GL_POLYGON);
-            float centerX = 130 + cx * 50;
-            float centerY = WINDOW_HEIGHT / 1.6 + cy * 60;  // Adjust to connect with trunk
-            float radius = 30;
-            for (int i = 0; i < 12; i++) {
-                float angle = 2.0f * M_PI * i / 12;
-                glVertex2f(centerX + radius * cos(angle), centerY + radius * sin(angle));
-            }
-            glEnd();
-        }
-    }
+    glutDisplayFunc(display);
+    glutReshapeFunc(reshape);
+    glutIdleFunc(idle);
+    glutMouseFunc(mouseClick);
+    glutKeyboardFunc(keyboard);
+    glutPassiveMotionFunc(passiveMouseMotion);
+    glutSetCursor(GLUT_CURSOR_NONE);
 
-    // Bush
-    glColor3f(0.7f, 0.9f, 0.0f);
-    glBegin(GL_POLYGON);
-    float bushX = WINDOW_WIDTH - 100;
-    float bushY = WINDOW_HEIGHT / 3.5 + 30;
-    float bushRadius = 40;
-    for (int i = 0; i < 12; i++) {
-        float angle = 2.0f * M_PI * i / 12;
-        glVertex2f(bushX + bushRadius * cos(angle), bushY + bushRadius * sin(angle));
+    if (!initDuckRenderer(lookupGlProc)) {
+        std::cout << "Instanced rendering unavailable, drawing ducks in immediate mode" << std::endl;
     }
-    glEnd();
-}
+    if (renderer == RENDER_SOFT) {
+        initSoftRenderer(renderThreads);
+    }
+    initProfiler();
 
-void updateAndDrawFloatingTexts() {
-    for (auto it = floatingTexts.begin(); it != floatingTexts.end();) {
-        it->y += it->speed;
-        it->alpha -= 0.02f;
+    if (!setSwapInterval(gameLoop.pacing == FRAME_VSYNC ? 1 : 0) && gameLoop.pacing == FRAME_VSYNC) {
+        std::cout << "Cannot enable vsync, capping at 60 fps instead" << std::endl;
+        gameLoop.pacing = FRAME_CAPPED;
+    }
 
-        if (it->alpha <= 0.0f) {
-            it = floatingTexts.erase(it);
-        }
-        else {
-            ++it;
+    if (replayPath) {
+        if (!readInputLog(replayPath, inputLog)) {
+            std::cout << "Cannot read replay log " << replayPath << std::endl;
+            return 1;
         }
+        sim.loop.replay = &inputLog;
     }
-
-    glMatrixMode(GL_PROJECTION);
-    glPushMatrix();
-    glLoadIdentity();
-    gluOrtho2D(0, WINDOW_WIDTH, 0, WINDOW_HEIGHT);
-    glMatrixMode(GL_MODELVIEW);
-    glPushMatrix();
-    glLoadIdentity();
-
-    for (const auto& ft : floatingTexts) {
-        glColor4f(1.0f, 1.0f, 0.0f, ft.alpha);
-        glRasterPos2f(ft.x, ft.y);
-        for (char c : ft.text) {
-            glutBitmapCharacter(GLUT_BITMAP_HELVETICA_12, c);
+    else {
+        // Printed so an interesting game can be played again with --seed
+        std::cout << "Seed " << seed << std::endl;
+        inputLog.seed = seed;
+        if (botPlaying) {
+            sim.loop.bot = &bot;
+            sim.loop.botLog = recordPath ? &inputLog : nullptr;
         }
     }
+    if (telemetryEnabled && startTelemetry(telemetry, telemetryConfig)) {
+        sim.world.telemetry = &telemetry;
+    }
+    startFromLog(sim.world, inputLog);
+    sim.recordLog = recordPath ? &inputLog : nullptr;
+    atexit(printRenderStats);
+    startSimThread(sim, secondsNow);
+    if (audioEnabled) {
+        startGameAudio();
+    }
+    glutMainLoop();
+    return 0;
+}
 
-    glPopMatrix();
-    glMatrixMode(GL_PROJECTION);
-    glPopMatrix();
-    glMatrixMode(GL_MODELVIEW);
+int getDigitCount(int number) {
+    if (number == 0) return 1;
+    int count = 0;
+    while (number > 0) {
+        number /= 10;
+        count++;
+    }
+    return count;
 }
 
-void addFloatingText(float x, float y, int points) {
-    FloatingText ft;
-    ft.x = x;
-    ft.y = y;
-    ft.alpha = 1.0f;
-    ft.speed = 1.0f;
-    ft.text = "+" + std::to_string(points);
-    floatingTexts.push_back(ft);
+// Live input is ignored while a replay or the bot is driving the world
+static bool playerInControl() {
+    return !replayPath && !sim.loop.bot;
 }
 
-void drawHUD() {
-    glMatrixMode(GL_PROJECTION);
-    glPushMatrix();
-    glLoadIdentity();
-    gluOrtho2D(0, WINDOW_WIDTH, 0, WINDOW_HEIGHT);
-    glMatrixMode(GL_MODELVIEW);
-    glPushMatrix();
-    glLoadIdentity();
+static bool submitPlayerInput(int type, int x, int y) {
+    if (!playerInControl()) {
+        return false;
+    }
+    postSimInput(sim, type, x, WINDOW_HEIGHT - y, shownTick);
+    requestRedraw(gameLoop);
+    return true;
+}
 
-    glColor3f(0.6f, 0.3f, 0.1f);
-    glBegin(GL_QUADS);
-    glVertex2f(0, 0);
-    glVertex2f(WINDOW_WIDTH, 0);
-    glVertex2f(WINDOW_WIDTH, WINDOW_HEIGHT / 10);
-    glVertex2f(0, WINDOW_HEIGHT / 10);
-    glEnd();
-
-    glColor3f(0.0f, 0.0f, 0.0f);
-    glBegin(GL_QUADS);
-    glVertex2f(10, WINDOW_HEIGHT / 60);
-    glVertex2f(120, WINDOW_HEIGHT / 60);
-    glVertex2f(120, WINDOW_HEIGHT * 0.09);
-    glVertex2f(10, WINDOW_HEIGHT * 0.09);
-    glEnd();
-
-    glColor3f(1.0f, 0.6f, 0.0f);
-    glRasterPos2f(15, WINDOW_HEIGHT / 20);
-    std::string shotText = "SHOT";
-    for (char c : shotText) {
-        glutBitmapCharacter(GLUT_BITMAP_HELVETICA_12, c);
-    }
-
-    for (int i = 0; i < 3 - missedShots % 3; i++) {
-        glColor3f(0.7f, 0.5f, 0.1f);
-        glBegin(GL_QUADS);
-        glVertex2f(55 + i * 20, WINDOW_HEIGHT / 40);
-        glVertex2f(70 + i * 20, WINDOW_HEIGHT / 40);
-        glVertex2f(70 + i * 20, WINDOW_HEIGHT / 18);
-        glVertex2f(55 + i * 20, WINDOW_HEIGHT / 18);
-        glEnd();
-
-        glColor3f(0.0f, 0.5f, 1.0f);
-        glBegin(GL_QUADS);
-        glVertex2f(55 + i * 20, WINDOW_HEIGHT / 18);
-        glVertex2f(70 + i * 20, WINDOW_HEIGHT / 18);
-        glVertex2f(70 + i * 20, WINDOW_HEIGHT / 13);
-        glVertex2f(55 + i * 20, WINDOW_HEIGHT / 13);
-        glEnd();
-    }
-
-    glColor3f(0.0f, 0.0f, 0.0f);
-    glBegin(GL_QUADS);
-    glVertex2f(130, WINDOW_HEIGHT / 60);
-    glVertex2f(WINDOW_WIDTH - 160, WINDOW_HEIGHT / 60);
-    glVertex2f(WINDOW_WIDTH - 160, WINDOW_HEIGHT * 0.09);
-    glVertex2f(130, WINDOW_HEIGHT * 0.09);
-    glEnd();
-
-    glColor3f(1.0f, 0.9f, 0.0f);
-    glRasterPos2f(140, WINDOW_HEIGHT / 20);
-    std::string hitText = "HIT";
-    for (char c : hitText) {
-        glutBitmapCharacter(GLUT_BITMAP_HELVETICA_12, c);
-    }
-
-    glColor3f(1.0f, 1.0f, 1.0f);
-    glLineWidth(2.0f);
-    int hitMarkWidth = (WINDOW_WIDTH - 350) / 10;
-    for (int i = 0; i < score % 10; i++) {
-        glBegin(GL_LINE_STRIP);
-        glVertex2f(180 + i * hitMarkWidth, WINDOW_HEIGHT / 45);
-        glVertex2f(180 + i * hitMarkWidth + hitMarkWidth / 2, WINDOW_HEIGHT / 15);
-        glVertex2f(180 + i * hitMarkWidth + hitMarkWidth, WINDOW_HEIGHT / 45);
-        glEnd();
-    }
-
-    // New score display similar to image
-    glColor3f(0.0f, 0.0f, 0.0f);
-    glBegin(GL_QUADS);
-    glVertex2f(WINDOW_WIDTH - 150, WINDOW_HEIGHT / 60);
-    glVertex2f(WINDOW_WIDTH - 10, WINDOW_HEIGHT / 60);
-    glVertex2f(WINDOW_WIDTH - 10, WINDOW_HEIGHT * 0.09);
-    glVertex2f(WINDOW_WIDTH - 150, WINDOW_HEIGHT * 0.09);
-    glEnd();
-
-    // Dark green background for score display
-    glColor3f(0.0f, 0.2f, 0.0f);
-    glBegin(GL_QUADS);
-    glVertex2f(WINDOW_WIDTH - 145, WINDOW_HEIGHT / 40);
-    glVertex2f(WINDOW_WIDTH - 15, WINDOW_HEIGHT / 40);
-    glVertex2f(WINDOW_WIDTH - 15, WINDOW_HEIGHT * 0.08);
-    glVertex2f(WINDOW_WIDTH - 145, WINDOW_HEIGHT * 0.08);
-    glEnd();
-
-    // Score text
-    std::string scoreStr = std::to_string(score);
-    while (scoreStr.length() < 6) {
-        scoreStr = "0" + scoreStr;  // Pad with leading zeros
-    }
-
-    glColor3f(0.8f, 0.8f, 0.0f);  // Yellow/gold color for score
-    glRasterPos2f(WINDOW_WIDTH - 140, WINDOW_HEIGHT / 20);
-    std::string scoreText = "SCORE";
-    for (char c : scoreText) {
-        glutBitmapCharacter(GLUT_BITMAP_HELVETICA_12, c);
-    }
-
-    // Display score digits
-    glRasterPos2f(WINDOW_WIDTH - 95, WINDOW_HEIGHT / 20);
-    for (char c : scoreStr) {
-        glutBitmapCharacter(GLUT_BITMAP_9_BY_15, c);
-    }
-
-    // Add shots remaining display
-    glColor3f(1.0f, 1.0f, 1.0f);
-    glRasterPos2f(15, WINDOW_HEIGHT / 20 + 20);
-    std::string shotsText = "SHOTS: " + std::to_string(shotsRemaining) + "/" + std::to_string(SHOTS_PER_ROUND);
-    for (char c : shotsText) {
-        glutBitmapCharacter(GLUT_BITMAP_HELVETICA_12, c);
-    }
-
-    if (gameOver || roundOver) {
-        std::string endMessage = gameOver ? "GAME OVER!" : "ROUND OVER!";
-        std::string scoreStr = "Final Score: " + std::to_string(score);
-        std::string restartStr = "Click to Restart";
-
-        glColor3f(1.0f, 0.0f, 0.0f);
-        glRasterPos2f(WINDOW_WIDTH / 2 - 100, WINDOW_HEIGHT / 2);
-        for (char c : endMessage) {
-            glutBitmapCharacter(GLUT_BITMAP_HELVETICA_18, c);
-        }
+void passiveMouseMotion(int x, int y) {
+    if (submitPlayerInput(INPUT_MOTION, x, y)) {
+        pushPointerSample(pointerInput, secondsNow(), x, y);
+    }
+}
 
-        glRasterPos2f(WINDOW_WIDTH / 2 - 60, WINDOW_HEIGHT / 2 - 30);
-        for (char c : scoreStr) {
-            glutBitmapCharacter(GLUT_BITMAP_HELVETICA_18, c);
-        }
+// Asks the window system where the cursor is right now, in the same window
+// pixels the GLUT callbacks use. Returns false where there is no way to.
+static bool pollCursor(int& x, int& y) {
+#if defined(_WIN32)
+    HWND window = WindowFromDC(wglGetCurrentDC());
+    POINT point;
+    if (!window || !GetCursorPos(&point) || !ScreenToClient(window, &point)) {
+        return false;
+    }
+    x = point.x;
+    y = point.y;
+#elif defined(DUCKHUNT_X11)
+    Display* display = glXGetCurrentDisplay();
+    GLXDrawable window = glXGetCurrentDrawable();
+    ::Window root, child;
+    int rootX, rootY;
+    unsigned int buttons;
+    if (!display || !window || !XQueryPointer(display, window, &root, &child, &rootX, &rootY, &x, &y, &buttons)) {
+        return false;
+    }
+#else
+    return false;
+#endif
+    // Outside the window GLUT reports no motion either
+    return x >= 0 && y >= 0 && x < glutGet(GLUT_WINDOW_WIDTH) && y < glutGet(GLUT_WINDOW_HEIGHT);
+}
 
-        glRasterPos2f(WINDOW_WIDTH / 2 - 60, WINDOW_HEIGHT / 2 - 60);
-        for (char c : restartStr) {
-            glutBitmapCharacter(GLUT_BITMAP_HELVETICA_18, c);
-        }
+// The crosshair follows the newest pointer sample rather than the world,
+// which only hears about motion when the callbacks run. A poll just before
+// drawing catches whatever moved since.
+static void latchCrosshair(int& x, int& y) {
+    x = simSnapshot(sim).world.pointerX;
+    y = simSnapshot(sim).world.pointerY;
+    if (!playerInControl()) {
+        return;
     }
 
-    glPopMatrix();
-    glMatrixMode(GL_PROJECTION);
-    glPopMatrix();
-    glMatrixMode(GL_MODELVIEW);
+    int polledX, polledY;
+    PointerSample sample;
+    if (pollCursor(polledX, polledY)
+        && (!newestPointerSample(pointerInput, sample) || polledX != sample.x || polledY != sample.y)) {
+        pushPointerSample(pointerInput, secondsNow(), polledX, polledY);
+    }
+    if (latchPointerFrame(pointerInput, sample)) {
+        x = sample.x;
+        y = WINDOW_HEIGHT - sample.y;
+    }
 }
 
 void display() {
+    static bool textReady = false;
+    if (!textReady) {
+        // The atlas is rasterized through the back buffer, so build it
+        // before anything of the first frame is drawn
+        textReady = true;
+        if (!initTextRenderer(glutGlyphSource)) {
+            std::cout << "Window too small for the glyph atlas, drawing text with glutBitmapCharacter" << std::endl;
+        }
+    }
+
+    beginPhase(PHASE_FRAME);
     glClear(GL_COLOR_BUFFER_BIT);
-    drawBackground();
 
-    for (const Duck& duck : ducks) {
-        if (duck.active) {
-            drawDuck(duck);
-        }
+    // The snapshot stays put until the next takeSimSnapshot() in idle()
+    const SimSnapshot& snapshot = simSnapshot(sim);
+    followSimulation(gameLoop, snapshot.stepTime, secondsNow());
+    const RenderBackend& backend = renderBackend(renderer);
+    float alpha = interpolationAlpha(gameLoop);
+    backend.drawScene(snapshot.world, alpha);
+
+    beginPhase(PHASE_CROSSHAIR);
+    int crosshairX, crosshairY;
+    latchCrosshair(crosshairX, crosshairY);
+    backend.drawCrosshair(crosshairX, crosshairY);
+    endPhase(PHASE_CROSSHAIR);
+    beginPhase(PHASE_PRESENT);
+    backend.finishFrame();
+    endPhase(PHASE_PRESENT);
+
+    if (showProfiler) {
+        drawProfilerOverlay();
+        flushText();
     }
+    endPhase(PHASE_FRAME);
 
-    updateAndDrawFloatingTexts();
-    drawHUD();
-    drawCrosshair();
     glutSwapBuffers();
+    // What a click from now on is aimed at
+    shownTick = static_cast<double>(snapshot.world.tick) - 1.0 + alpha;
+    presentPointerFrame(pointerInput, secondsNow());
+    endProfilerFrame();
 }
 
 void reshape(int w, int h) {
     glViewport(0, 0, w, h);
+    invalidateBackground();
+    requestRedraw(gameLoop);
     glMatrixMode(GL_PROJECTION);
     glLoadIdentity();
     gluOrtho2D(0, WINDOW_WIDTH, 0, WINDOW_HEIGHT);
     glMatrixMode(GL_MODELVIEW);
 }
 
-void timer(int value) {
-    if (!gameOver && !roundOver) {
-        int currentTime = glutGet(GLUT_ELAPSED_TIME);
-        int deltaTime = currentTime - lastTime;
-        lastTime = currentTime;
-
-        timeRemaining -= deltaTime / 1000;
-        if (timeRemaining <= 0) {
-            timeRemaining = 0;
-            gameOver = true;
-        }
-
-        for (auto& duck : ducks) {
-            if (duck.active) {
-                duck.x += duck.dx;
-                duck.y += duck.dy;
-
-                duck.wingAngle += duck.wingDir * 0.2f;
-                if (duck.wingAngle < -DUCK_SIZE * 0.8f || duck.wingAngle > DUCK_SIZE * 0.8f) {
-                    duck.wingDir *= -1.0f;
-                }
-
-                float minHeight = WINDOW_HEIGHT / 3.5 + DUCK_SIZE * 2;
-                if (duck.y < minHeight) {
-                    duck.y = minHeight;
-                    duck.dy = fabs(duck.dy);
-                }
-
-                if (duck.y > WINDOW_HEIGHT - DUCK_SIZE) {
-                    duck.y = WINDOW_HEIGHT - DUCK_SIZE;
-                    duck.dy = -fabs(duck.dy);
-                }
-
-                if (duck.x < -DUCK_SIZE * 2 || duck.x > WINDOW_WIDTH + DUCK_SIZE * 2) {
-                    duck.active = false;
-                }
-            }
-        }
-
-        int activeDucks = 0;
-        for (const auto& duck : ducks) {
-            if (duck.active) {
-                activeDucks++;
-            }
+// One pass of the frame loop: pick up the newest world the simulation
+// thread published, then draw if the pacing policy says a frame is due.
+// Input callbacks only ask for a redraw, so any number of events between
+// frames cost one frame.
+void idle() {
+    double now = secondsNow();
+
+    if (takeSimSnapshot(sim)) {
+        const SimSnapshot& snapshot = simSnapshot(sim);
+        addPhaseSample(PHASE_SIMULATION, snapshot.passMs);
+        // Shots land a pass after the click that asked for the redraw
+        static unsigned int hudVersion = 0;
+        if (snapshot.world.hudVersion != hudVersion) {
+            hudVersion = snapshot.world.hudVersion;
+            requestRedraw(gameLoop);
         }
 
-        if (activeDucks < MAX_DUCKS) {
-            spawnDuck();
-        }
-
-        for (auto it = ducks.begin(); it != ducks.end();) {
-            if (!it->active) {
-                it = ducks.erase(it);
-            }
-            else {
-                ++it;
-            }
+        if (snapshot.replayFinished) {
+            bool match = worldChecksum(snapshot.world) == inputLog.checksum;
+            std::cout << "Replay finished, final state " << (match ? "matches" : "DIFFERS FROM") << " the recording" << std::endl;
+            exit(match ? 0 : 1);
         }
+    }
 
+    const SimSnapshot& snapshot = simSnapshot(sim);
+    followSimulation(gameLoop, snapshot.stepTime, now);
+    if (frameDue(gameLoop, snapshot.world, now)) {
         glutPostRedisplay();
+        return;
     }
 
-    glutTimerFunc(16, timer, 0);
+    // Leave a millisecond of slack for the OS scheduler
+    double wait = idleTime(gameLoop, snapshot.world, now) - 0.001;
+    if (wait > 0.0) {
+        std::this_thread::sleep_for(std::chrono::duration<double>(wait));
+    }
+}
+
+void keyboard(unsigned char key, int /*x*/, int /*y*/) {
+    if (key == 'p' || key == 'P') {
+        showProfiler = !showProfiler;
+        requestRedraw(gameLoop);
+    }
 }
 
 void mouseClick(int button, int state, int x, int y) {
     if (button == GLUT_LEFT_BUTTON && state == GLUT_DOWN) {
-        if (gameOver || roundOver) {
-            initGame();
-        }
-        else {
-            if (shotsRemaining <= 0) {
-                roundOver = true;
-                return;
-            }
-
-            int viewportY = WINDOW_HEIGHT - y;
-            shotsRemaining--;
-            totalShots++;
-
-            bool hitDuck = false;
-            for (auto& duck : ducks) {
-                if (duck.active) {
-                    float dx = duck.x - x;
-                    float dy = duck.y - viewportY;
-                    float distance = sqrt(dx * dx + dy * dy);
-
-                    if (distance < SHOT_RADIUS + DUCK_SIZE) {
-                        float currentTime = glutGet(GLUT_ELAPSED_TIME) / 1000.0f;
-                        float timeSinceSpawn = currentTime - duckSpawnTime;
-
-                        int bonusPoints = 0;
-                        if (timeSinceSpawn <= MAX_BONUS_TIME) {
-                            bonusPoints = BONUS_POINTS;
-                        }
-                        else if (timeSinceSpawn <= MAX_BONUS_TIME * 2) {
-                            float bonusFactor = 1.0f - (timeSinceSpawn - MAX_BONUS_TIME) / MAX_BONUS_TIME;
-                            bonusPoints = static_cast<int>(BONUS_POINTS * bonusFactor);
-                        }
-
-                        int pointsEarned = BASE_POINTS + bonusPoints;
-                        score += pointsEarned;
-
-                        addFloatingText(duck.x, duck.y, pointsEarned);
-
-                        duck.active = false;
-                        hitDuck = true;
-
-                        duckSpawnTime = currentTime;
-                        break;
-                    }
-                }
-            }
-
-            if (!hitDuck) {
-                missedShots++;
-            }
-
-            if (shotsRemaining <= 0) {
-                roundOver = true;
-            }
+        if (submitPlayerInput(INPUT_SHOT, x, y)) {
+            playSound(0);
         }
     }
-}
\ No newline at end of file
+}
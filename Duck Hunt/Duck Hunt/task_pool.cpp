@@ -0,0 +1,136 @@
+#include "task_pool.h"
+
+TaskPool::TaskPool(int threads) {
+    if (threads <= 0) {
+        threads = static_cast<int>(std::thread::hardware_concurrency());
+        if (threads <= 0) {
+            threads = 1;
+        }
+    }
+    for (int i = 0; i < threads; ++i) {
+        workers.push_back(std::unique_ptr<Worker>(new Worker));
+    }
+    for (int i = 0; i < threads; ++i) {
+        threadHandles.emplace_back(&TaskPool::run, this, i);
+    }
+}
+
+TaskPool::~TaskPool() {
+    {
+        std::lock_guard<std::mutex> lock(idleLock);
+        stopping = true;
+    }
+    wake.notify_all();
+    for (std::thread& thread : threadHandles) {
+        thread.join();
+    }
+}
+
+void TaskPool::submit(std::function<void()> task) {
+    Worker& worker = *workers[nextWorker];
+    nextWorker = (nextWorker + 1) % threads();
+
+    pending++;
+    {
+        std::lock_guard<std::mutex> lock(worker.lock);
+        worker.tasks.push_back(std::move(task));
+    }
+    queued++;
+
+    // Taking idleLock orders the queued++ before any sleeper's check
+    std::lock_guard<std::mutex> lock(idleLock);
+    wake.notify_one();
+}
+
+void TaskPool::wait() {
+    std::unique_lock<std::mutex> lock(idleLock);
+    finished.wait(lock, [this] { return pending.load() == 0; });
+}
+
+void TaskPool::forEach(int count, void (*body)(void* context, int index), void* context) {
+    if (count <= 0) {
+        return;
+    }
+    pending += count;
+    {
+        std::lock_guard<std::mutex> lock(idleLock);
+        batchBody = body;
+        batchContext = context;
+        batchNext = 0;
+        batchCount = count;
+        queued += count;
+    }
+    wake.notify_all();
+    wait();
+}
+
+bool TaskPool::takeTask(int self, std::function<void()>& task) {
+    {
+        Worker& own = *workers[self];
+        std::lock_guard<std::mutex> lock(own.lock);
+        if (!own.tasks.empty()) {
+            task = std::move(own.tasks.back());
+            own.tasks.pop_back();
+            queued--;
+            return true;
+        }
+    }
+
+    int count = threads();
+    for (int i = 1; i < count; ++i) {
+        Worker& victim = *workers[(self + i) % count];
+        std::lock_guard<std::mutex> lock(victim.lock);
+        if (!victim.tasks.empty()) {
+            task = std::move(victim.tasks.front());
+            victim.tasks.pop_front();
+            queued--;
+            stealCount++;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool TaskPool::takeIndex(int& index, void (*&body)(void*, int), void*& context) {
+    std::lock_guard<std::mutex> lock(idleLock);
+    if (batchNext >= batchCount) {
+        return false;
+    }
+    index = batchNext++;
+    body = batchBody;
+    context = batchContext;
+    queued--;
+    return true;
+}
+
+void TaskPool::finishTask() {
+    if (--pending == 0) {
+        std::lock_guard<std::mutex> lock(idleLock);
+        finished.notify_all();
+    }
+}
+
+void TaskPool::run(int self) {
+    for (;;) {
+        std::function<void()> task;
+        if (takeTask(self, task)) {
+            task();
+            finishTask();
+            continue;
+        }
+        int index;
+        void (*body)(void*, int);
+        void* context;
+        if (takeIndex(index, body, context)) {
+            body(context, index);
+            finishTask();
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(idleLock);
+        wake.wait(lock, [this] { return stopping || queued.load() > 0; });
+        if (stopping && queued.load() == 0) {
+            return;
+        }
+    }
+}
@@ -0,0 +1,66 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Fixed set of worker threads with one task deque each. submit() deals tasks
+// out round-robin; a worker runs its own newest task first and, once its
+// deque is empty, steals the oldest task of another worker. Long and short
+// tasks therefore even out without every thread contending on one queue.
+class TaskPool {
+public:
+    // threads <= 0 uses one worker per hardware thread.
+    explicit TaskPool(int threads);
+    ~TaskPool();
+
+    TaskPool(const TaskPool&) = delete;
+    TaskPool& operator=(const TaskPool&) = delete;
+
+    void submit(std::function<void()> task);
+
+    // Blocks until every task submitted so far has finished.
+    void wait();
+
+    // Runs body(context, i) for each i in [0, count) on the workers, then
+    // wait()s. Workers claim indices from a shared counter, so unlike
+    // submit() nothing is allocated: for work split the same way every
+    // frame. Call it from the thread that submits.
+    void forEach(int count, void (*body)(void* context, int index), void* context);
+
+    int threads() const { return static_cast<int>(workers.size()); }
+    long long steals() const { return stealCount.load(); }
+
+private:
+    struct Worker {
+        std::mutex lock;
+        std::deque<std::function<void()>> tasks;
+    };
+
+    bool takeTask(int self, std::function<void()>& task);
+    bool takeIndex(int& index, void (*&body)(void*, int), void*& context);
+    void finishTask();
+    void run(int self);
+
+    std::vector<std::unique_ptr<Worker>> workers;
+    std::vector<std::thread> threadHandles;
+    int nextWorker = 0;
+
+    std::mutex idleLock;                 // Guards sleeping and stopping
+    std::condition_variable wake;        // Tasks queued or stopping
+    std::condition_variable finished;    // pending dropped to 0
+    std::atomic<int> queued{0};          // Tasks in some deque or forEach() indices unclaimed
+    std::atomic<int> pending{0};         // Tasks submitted but not finished
+    std::atomic<long long> stealCount{0};
+    bool stopping = false;
+
+    // The running forEach(), guarded by idleLock
+    void (*batchBody)(void*, int) = nullptr;
+    void* batchContext = nullptr;
+    int batchNext = 0;
+    int batchCount = 0;
+};
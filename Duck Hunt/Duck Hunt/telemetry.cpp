@@ -0,0 +1,184 @@
+#include "telemetry.h"
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <vector>
+#ifdef DUCKHUNT_ZLIB
+#include <zlib.h>
+#endif
+
+static const char TELEMETRY_MAGIC[4] = {'D', 'H', 'T', 'L'};
+static const int TELEMETRY_VERSION = 1;
+static const size_t WRITE_BATCH = 4096;  // Records handed to one write call
+
+// One rotating file, compressed when zlib is built in
+struct TelemetryFile {
+#ifdef DUCKHUNT_ZLIB
+    gzFile file = nullptr;
+#else
+    FILE* file = nullptr;
+#endif
+    int index = 0;
+    long long bytes = 0;  // Uncompressed records written to it
+};
+
+static std::string filePath(const TelemetryConfig& config, int index) {
+#ifdef DUCKHUNT_ZLIB
+    const char* extension = ".dhtl.gz";
+#else
+    const char* extension = ".dhtl";
+#endif
+    return std::string(config.path) + "." + std::to_string(index) + extension;
+}
+
+static bool writeBytes(TelemetryFile& out, const void* data, size_t size) {
+#ifdef DUCKHUNT_ZLIB
+    return gzwrite(out.file, data, static_cast<unsigned>(size)) == static_cast<int>(size);
+#else
+    return fwrite(data, 1, size, out.file) == size;
+#endif
+}
+
+static bool closeFile(TelemetryFile& out) {
+    if (!out.file) {
+        return true;
+    }
+#ifdef DUCKHUNT_ZLIB
+    bool ok = gzclose(out.file) == Z_OK;
+#else
+    bool ok = fclose(out.file) == 0;
+#endif
+    out.file = nullptr;
+    return ok;
+}
+
+static bool openFile(Telemetry& telemetry, TelemetryFile& out, int index) {
+    std::string path = filePath(telemetry.config, index);
+#ifdef DUCKHUNT_ZLIB
+    // Fastest level: the writer has to keep up with a stress-mode flock
+    out.file = gzopen(path.c_str(), "wb1");
+#else
+    out.file = fopen(path.c_str(), "wb");
+#endif
+    if (!out.file) {
+        fprintf(stderr, "Cannot create telemetry file %s\n", path.c_str());
+        return false;
+    }
+    out.index = index;
+    out.bytes = 0;
+    telemetry.files.fetch_add(1, std::memory_order_relaxed);
+
+    unsigned char header[8];
+    for (int i = 0; i < 4; ++i) {
+        header[i] = static_cast<unsigned char>(TELEMETRY_MAGIC[i]);
+    }
+    header[4] = TELEMETRY_VERSION & 0xFF;
+    header[5] = TELEMETRY_VERSION >> 8;
+    header[6] = sizeof(TelemetryRecord) & 0xFF;
+    header[7] = sizeof(TelemetryRecord) >> 8;
+    if (!writeBytes(out, header, sizeof(header))) {
+        return false;
+    }
+
+    int keep = telemetry.config.keepFiles;
+    if (keep > 0 && index >= keep) {
+        remove(filePath(telemetry.config, index - keep).c_str());
+    }
+    return true;
+}
+
+// Moves everything queued into the current file, starting the next file
+// whenever one is full. Returns false once a file fails.
+static bool drain(Telemetry& telemetry, TelemetryFile& out, std::vector<TelemetryRecord>& batch) {
+    const long long recordBytes = sizeof(TelemetryRecord);
+    for (;;) {
+        // Never more than fits in the current file
+        long long room = (telemetry.config.fileBytes - out.bytes) / recordBytes;
+        size_t limit = room < static_cast<long long>(WRITE_BATCH) ? static_cast<size_t>(room > 1 ? room : 1) : WRITE_BATCH;
+        batch.clear();
+        TelemetryRecord record;
+        while (batch.size() < limit && telemetry.queue.pop(record)) {
+            batch.push_back(record);
+        }
+        if (batch.empty()) {
+            return true;
+        }
+        if (!writeBytes(out, batch.data(), batch.size() * sizeof(TelemetryRecord))) {
+            return false;
+        }
+        out.bytes += static_cast<long long>(batch.size()) * recordBytes;
+        telemetry.written.fetch_add(static_cast<long long>(batch.size()), std::memory_order_relaxed);
+
+        if (out.bytes >= telemetry.config.fileBytes) {
+            if (!closeFile(out) || !openFile(telemetry, out, out.index + 1)) {
+                return false;
+            }
+        }
+    }
+}
+
+static void writeLoop(Telemetry& telemetry, TelemetryFile out) {
+    using namespace std::chrono;
+    std::vector<TelemetryRecord> batch;
+    batch.reserve(WRITE_BATCH);
+    bool ok = true;
+    bool busy = false;  // The last drain took a good part of the queue
+    for (;;) {
+        bool stopping;
+        {
+            std::unique_lock<std::mutex> lock(telemetry.wakeLock);
+            if (!busy) {
+                telemetry.wake.wait_for(lock, milliseconds(telemetry.config.drainMs), [&] { return telemetry.stopping; });
+            }
+            stopping = telemetry.stopping;
+        }
+        // After a failure the queue fills up and the rest counts as dropped
+        long long before = telemetry.written.load(std::memory_order_relaxed);
+        if (ok) {
+            ok = drain(telemetry, out, batch);
+        }
+        busy = ok && telemetry.written.load(std::memory_order_relaxed) - before >= static_cast<long long>(TELEMETRY_QUEUE_SIZE / 4);
+        if (stopping) {
+            break;
+        }
+    }
+    ok = closeFile(out) && ok;
+    if (!ok) {
+        telemetry.failed.store(true, std::memory_order_relaxed);
+    }
+}
+
+bool startTelemetry(Telemetry& telemetry, const TelemetryConfig& config) {
+    telemetry.config = config;
+    telemetry.stopping = false;
+    TelemetryFile out;
+    if (!openFile(telemetry, out, 0)) {
+        closeFile(out);
+        telemetry.failed.store(true, std::memory_order_relaxed);
+        return false;
+    }
+    telemetry.writer = std::thread(writeLoop, std::ref(telemetry), out);
+    return true;
+}
+
+void stopTelemetry(Telemetry& telemetry) {
+    if (!telemetry.writer.joinable()) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(telemetry.wakeLock);
+        telemetry.stopping = true;
+    }
+    telemetry.wake.notify_one();
+    telemetry.writer.join();
+}
+
+TelemetryStats telemetryStats(const Telemetry& telemetry) {
+    TelemetryStats stats;
+    stats.recorded = telemetry.recorded.load(std::memory_order_relaxed);
+    stats.dropped = telemetry.dropped.load(std::memory_order_relaxed);
+    stats.written = telemetry.written.load(std::memory_order_relaxed);
+    stats.files = telemetry.files.load(std::memory_order_relaxed);
+    stats.failed = telemetry.failed.load(std::memory_order_relaxed);
+    return stats;
+}
@@ -0,0 +1,92 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include "spsc_queue.h"
+
+// Gameplay events for operations: every spawn, hit, miss, escape and end of
+// a round or game. The thread stepping the World pushes fixed-size records
+// onto a wait-free queue (no lock, no allocation, no waiting; a full queue
+// drops the record and counts it), and a writer thread drains the queue
+// into rotating log files, gzip-compressed where zlib is available.
+//
+//   startTelemetry(telemetry, config);
+//   world.telemetry = &telemetry;  // The simulation records from here on
+//   ...
+//   stopTelemetry(telemetry);      // After the last step, writes the rest
+//
+// Each file holds the bytes "DHTL", a 16-bit version and a 16-bit record
+// size, little-endian, then records as laid out below in host order.
+enum TelemetryEvent {
+    TELEMETRY_SPAWN,
+    TELEMETRY_HIT,
+    TELEMETRY_MISS,
+    TELEMETRY_ESCAPE,      // Flew off the screen
+    TELEMETRY_ROUND_OVER,  // Out of shots
+    TELEMETRY_GAME_OVER    // Out of time
+};
+
+struct TelemetryRecord {
+    int64_t tick;          // World::tick the event happened at
+    uint16_t type;         // TelemetryEvent
+    uint16_t mode;         // GameModeId
+    float x, y;            // The duck, or the shot for a miss
+    int32_t points;        // Hit: points earned. Round and game over: the score
+    int32_t bonus;         // Hit: the bonus part of points. Round and game over: shots fired
+    float timeSinceSpawn;  // Hit: seconds since the last spawn or hit
+};
+static_assert(sizeof(TelemetryRecord) == 32, "telemetry records are written as they are laid out");
+
+const size_t TELEMETRY_QUEUE_SIZE = 16384;  // Records; a stress-mode restart spawns 10000
+
+struct TelemetryConfig {
+    const char* path = "telemetry";   // Files are path.0.dhtl.gz, path.1.dhtl.gz...
+    long long fileBytes = 64 << 20;   // Uncompressed record bytes before the next file
+    int keepFiles = 8;                // Older files are deleted; <= 0 keeps every one
+    int drainMs = 20;                 // Writer sleep when the queue is empty
+};
+
+struct TelemetryStats {
+    long long recorded;  // Pushed by the simulation
+    long long dropped;   // Refused by a full queue
+    long long written;   // Reached a file
+    int files;           // Opened so far
+    bool failed;         // A file could not be opened or written
+};
+
+struct Telemetry {
+    SpscQueue<TelemetryRecord, TELEMETRY_QUEUE_SIZE> queue;
+    std::atomic<long long> recorded{0};
+    std::atomic<long long> dropped{0};
+
+    // Writer side
+    TelemetryConfig config;
+    std::thread writer;
+    std::mutex wakeLock;  // Guards only the writer's sleep
+    std::condition_variable wake;
+    bool stopping = false;
+    std::atomic<long long> written{0};
+    std::atomic<int> files{0};
+    std::atomic<bool> failed{false};
+};
+
+// Starts the writer thread. Returns false if the first file cannot be
+// created.
+bool startTelemetry(Telemetry& telemetry, const TelemetryConfig& config);
+
+// Writes out what is still queued, closes the file and joins the writer.
+// Does nothing if it is not running.
+void stopTelemetry(Telemetry& telemetry);
+
+// Producer side, from the one thread stepping the World. The counters
+// have a single writer, so they are bumped without a locked instruction.
+inline void recordTelemetry(Telemetry& telemetry, const TelemetryRecord& record) {
+    telemetry.recorded.store(telemetry.recorded.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    if (!telemetry.queue.push(record)) {
+        telemetry.dropped.store(telemetry.dropped.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    }
+}
+
+TelemetryStats telemetryStats(const Telemetry& telemetry);
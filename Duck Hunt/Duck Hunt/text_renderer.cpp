@@ -0,0 +1,237 @@
+#include "text_renderer.h"
+#include "gl_ext.h"
+#include <vector>
+
+const int ATLAS_WIDTH = 512;
+const int FIRST_GLYPH = 32;
+const int GLYPH_COUNT = 95;   // Printable ASCII
+const int GLYPH_PAD = 1;      // Empty columns either side of a glyph
+const int GLYPH_DESCENT = 7;  // Room below the baseline for descenders
+
+struct Glyph {
+    int x, y;           // Cell position in the atlas
+    int width, height;  // Cell size
+    int advance;
+};
+
+struct TextVertex {
+    float x, y;
+    float u, v;
+    GLubyte color[4];
+};
+
+static GlyphSource glyphSource;
+static Glyph glyphs[TEXT_FONT_COUNT][GLYPH_COUNT];
+static int atlasHeight = 0;
+static GLuint atlasTexture = 0;
+static bool atlasReady = false;
+static std::vector<GLubyte> atlasPixels;  // CPU copy for takeTextQuads() users
+static std::vector<TextVertex> vertices;
+static int lastGlyphCount = 0;
+
+// Shelf-packs every glyph cell and returns the atlas height needed.
+static int layoutAtlas() {
+    int x = 0, y = 0, shelfHeight = 0;
+    for (int font = 0; font < TEXT_FONT_COUNT; ++font) {
+        int height = glyphSource.lineHeight(font) + GLYPH_DESCENT;
+        for (int i = 0; i < GLYPH_COUNT; ++i) {
+            Glyph& glyph = glyphs[font][i];
+            glyph.advance = glyphSource.glyphAdvance(font, static_cast<char>(FIRST_GLYPH + i));
+            glyph.width = glyph.advance + 2 * GLYPH_PAD;
+            glyph.height = height;
+
+            if (x + glyph.width > ATLAS_WIDTH) {
+                x = 0;
+                y += shelfHeight;
+                shelfHeight = 0;
+            }
+            glyph.x = x;
+            glyph.y = y;
+            x += glyph.width;
+            if (height > shelfHeight) {
+                shelfHeight = height;
+            }
+        }
+    }
+
+    int needed = y + shelfHeight;
+    int height = 1;
+    while (height < needed) {
+        height *= 2;
+    }
+    return height;
+}
+
+bool initTextRenderer(const GlyphSource& source) {
+    glyphSource = source;
+    atlasHeight = layoutAtlas();
+
+    GLint viewport[4];
+    glGetIntegerv(GL_VIEWPORT, viewport);
+    if (viewport[2] < ATLAS_WIDTH || viewport[3] < atlasHeight) {
+        return false;
+    }
+
+    // Draw all glyphs white on black in pixel coordinates and read them back
+    glMatrixMode(GL_PROJECTION);
+    glPushMatrix();
+    glLoadIdentity();
+    glOrtho(0, viewport[2], 0, viewport[3], -1, 1);
+    glMatrixMode(GL_MODELVIEW);
+    glPushMatrix();
+    glLoadIdentity();
+
+    GLfloat clearColor[4];
+    glGetFloatv(GL_COLOR_CLEAR_VALUE, clearColor);
+    glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
+    glClear(GL_COLOR_BUFFER_BIT);
+    glColor3f(1.0f, 1.0f, 1.0f);
+    for (int font = 0; font < TEXT_FONT_COUNT; ++font) {
+        for (int i = 0; i < GLYPH_COUNT; ++i) {
+            const Glyph& glyph = glyphs[font][i];
+            glRasterPos2i(glyph.x + GLYPH_PAD, glyph.y + GLYPH_DESCENT);
+            glyphSource.drawGlyph(font, static_cast<char>(FIRST_GLYPH + i));
+        }
+    }
+
+    std::vector<GLubyte>& pixels = atlasPixels;
+    pixels.assign(ATLAS_WIDTH * atlasHeight, 0);
+    glPixelStorei(GL_PACK_ALIGNMENT, 1);
+    glReadPixels(viewport[0], viewport[1], ATLAS_WIDTH, atlasHeight, GL_RED, GL_UNSIGNED_BYTE, pixels.data());
+    glClear(GL_COLOR_BUFFER_BIT);
+    glClearColor(clearColor[0], clearColor[1], clearColor[2], clearColor[3]);
+
+    glPopMatrix();
+    glMatrixMode(GL_PROJECTION);
+    glPopMatrix();
+    glMatrixMode(GL_MODELVIEW);
+
+    glGenTextures(1, &atlasTexture);
+    glBindTexture(GL_TEXTURE_2D, atlasTexture);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_ALPHA8, ATLAS_WIDTH, atlasHeight, 0, GL_ALPHA, GL_UNSIGNED_BYTE, pixels.data());
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    vertices.reserve(4096);
+    atlasReady = glGetError() == GL_NO_ERROR;
+    return atlasReady;
+}
+
+static GLubyte toByte(float value) {
+    if (value <= 0.0f) return 0;
+    if (value >= 1.0f) return 255;
+    return static_cast<GLubyte>(value * 255.0f + 0.5f);
+}
+
+void drawText(int font, float x, float y, float r, float g, float b, float a, const char* text) {
+    if (!atlasReady) {
+        glColor4f(r, g, b, a);
+        glRasterPos2f(x, y);
+        for (const char* c = text; *c; ++c) {
+            glyphSource.drawGlyph(font, *c);
+        }
+        return;
+    }
+
+    GLubyte color[4] = {toByte(r), toByte(g), toByte(b), toByte(a)};
+    float texelWidth = 1.0f / ATLAS_WIDTH;
+    float texelHeight = 1.0f / atlasHeight;
+
+    for (const char* c = text; *c; ++c) {
+        int index = *c - FIRST_GLYPH;
+        if (index < 0 || index >= GLYPH_COUNT) {
+            continue;
+        }
+        const Glyph& glyph = glyphs[font][index];
+
+        float x0 = x - GLYPH_PAD;
+        float y0 = y - GLYPH_DESCENT;
+        float x1 = x0 + glyph.width;
+        float y1 = y0 + glyph.height;
+        float u0 = glyph.x * texelWidth;
+        float v0 = glyph.y * texelHeight;
+        float u1 = (glyph.x + glyph.width) * texelWidth;
+        float v1 = (glyph.y + glyph.height) * texelHeight;
+
+        TextVertex quad[4] = {
+            {x0, y0, u0, v0, {color[0], color[1], color[2], color[3]}},
+            {x1, y0, u1, v0, {color[0], color[1], color[2], color[3]}},
+            {x1, y1, u1, v1, {color[0], color[1], color[2], color[3]}},
+            {x0, y1, u0, v1, {color[0], color[1], color[2], color[3]}},
+        };
+        vertices.insert(vertices.end(), quad, quad + 4);
+        x += glyph.advance;
+    }
+}
+
+void drawText(int font, float x, float y, float r, float g, float b, const char* text) {
+    drawText(font, x, y, r, g, b, 1.0f, text);
+}
+
+void flushText() {
+    lastGlyphCount = static_cast<int>(vertices.size()) / 4;
+    if (vertices.empty()) {
+        return;
+    }
+
+    glEnable(GL_TEXTURE_2D);
+    glBindTexture(GL_TEXTURE_2D, atlasTexture);
+    glTexEnvi(GL_TEXTURE_ENV, GL_TEXTURE_ENV_MODE, GL_MODULATE);
+    glEnable(GL_BLEND);
+    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+
+    glEnableClientState(GL_VERTEX_ARRAY);
+    glEnableClientState(GL_TEXTURE_COORD_ARRAY);
+    glEnableClientState(GL_COLOR_ARRAY);
+    glVertexPointer(2, GL_FLOAT, sizeof(TextVertex), &vertices[0].x);
+    glTexCoordPointer(2, GL_FLOAT, sizeof(TextVertex), &vertices[0].u);
+    glColorPointer(4, GL_UNSIGNED_BYTE, sizeof(TextVertex), vertices[0].color);
+    glDrawArrays(GL_QUADS, 0, static_cast<GLsizei>(vertices.size()));
+    glDisableClientState(GL_COLOR_ARRAY);
+    glDisableClientState(GL_TEXTURE_COORD_ARRAY);
+    glDisableClientState(GL_VERTEX_ARRAY);
+
+    glDisable(GL_BLEND);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    glDisable(GL_TEXTURE_2D);
+    vertices.clear();
+}
+
+void takeTextQuads(std::vector<TextQuad>& quads) {
+    lastGlyphCount = static_cast<int>(vertices.size()) / 4;
+    for (size_t i = 0; i < vertices.size(); i += 4) {
+        const TextVertex& low = vertices[i];
+        const TextVertex& high = vertices[i + 2];
+        // Texture coordinates are texel edges over power-of-two sizes, so
+        // they convert back exactly
+        TextQuad quad;
+        quad.x = low.x;
+        quad.y = low.y;
+        quad.atlasX = static_cast<int>(low.u * ATLAS_WIDTH);
+        quad.atlasY = static_cast<int>(low.v * atlasHeight);
+        quad.width = static_cast<int>(high.u * ATLAS_WIDTH) - quad.atlasX;
+        quad.height = static_cast<int>(high.v * atlasHeight) - quad.atlasY;
+        for (int c = 0; c < 4; ++c) {
+            quad.color[c] = low.color[c];
+        }
+        quads.push_back(quad);
+    }
+    vertices.clear();
+}
+
+const unsigned char* textAtlas(int& width, int& height) {
+    if (!atlasReady) {
+        return nullptr;
+    }
+    width = ATLAS_WIDTH;
+    height = atlasHeight;
+    return atlasPixels.data();
+}
+
+int textGlyphCount() {
+    return lastGlyphCount;
+}
@@ -0,0 +1,56 @@
+#pragma once
+#include <vector>
+
+// Bitmap text through a glyph atlas. The fonts are rasterized once into an
+// alpha texture; drawText() only queues quads and flushText() draws every
+// queued glyph of the frame with a single glDrawArrays.
+enum TextFont {
+    TEXT_HELVETICA_12,
+    TEXT_HELVETICA_18,
+    TEXT_FIXED_9_BY_15,
+    TEXT_FONT_COUNT
+};
+
+// Where glyph pixels come from. drawGlyph must render like glBitmap at the
+// current raster position (glutBitmapCharacter does). Keeping this a set of
+// callbacks leaves the renderer free of any GLUT dependency.
+struct GlyphSource {
+    void (*drawGlyph)(int font, char c);
+    int (*glyphAdvance)(int font, char c);
+    int (*lineHeight)(int font);
+};
+
+// Builds the atlas by drawing every printable glyph into the back buffer and
+// reading it back, so call it before the first frame is drawn. Returns false
+// if the viewport is too small to hold the atlas, in which case drawText()
+// falls back to drawing glyphs directly.
+bool initTextRenderer(const GlyphSource& source);
+
+// Queues text with its baseline origin at (x, y), like glRasterPos2f.
+void drawText(int font, float x, float y, float r, float g, float b, float a, const char* text);
+void drawText(int font, float x, float y, float r, float g, float b, const char* text);
+
+// Draws everything queued since the last flush.
+void flushText();
+
+// A queued glyph for renderers that blend it themselves: the atlas cell at
+// (atlasX, atlasY) placed with its lower-left corner at (x, y), coverage
+// times color, one texel per pixel.
+struct TextQuad {
+    float x, y;
+    int atlasX, atlasY;
+    int width, height;
+    unsigned char color[4];
+};
+
+// Appends the glyphs queued since the last flush to quads instead of
+// drawing them. Only the atlas queues glyphs; without it text is drawn
+// straight away and never reaches here.
+void takeTextQuads(std::vector<TextQuad>& quads);
+
+// The atlas as one coverage byte per texel, bottom row first, or null if
+// initTextRenderer() could not build it.
+const unsigned char* textAtlas(int& width, int& height);
+
+// Glyphs drawn by the last flushText() or takeTextQuads()
+int textGlyphCount();
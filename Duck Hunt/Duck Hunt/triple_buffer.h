@@ -0,0 +1,41 @@
+#pragma once
+#include <atomic>
+
+// Newest-value handoff from exactly one writer thread to exactly one reader
+// thread. There are three slots: the writer fills its back slot and swaps it
+// with the middle one, and the reader swaps its front slot for the middle
+// one when a newer value is there. Each side does one atomic exchange and
+// never waits for the other. The reader always sees a whole slot that stays
+// unchanged until its next update(); values published faster than they are
+// read are skipped.
+template <typename T>
+class TripleBuffer {
+public:
+    // Writer side: fill back(), then publish() it.
+    T& back() { return slots[backIndex]; }
+
+    void publish() {
+        backIndex = middle.exchange(backIndex | FRESH, std::memory_order_acq_rel) & INDEX;
+    }
+
+    // Reader side. Moves front() to the newest published value and returns
+    // true, or returns false if nothing was published since the last call.
+    bool update() {
+        if (!(middle.load(std::memory_order_relaxed) & FRESH)) {
+            return false;
+        }
+        frontIndex = middle.exchange(frontIndex, std::memory_order_acq_rel) & INDEX;
+        return true;
+    }
+
+    const T& front() const { return slots[frontIndex]; }
+
+private:
+    static const int INDEX = 3;
+    static const int FRESH = 4;  // Set while the middle slot is unread
+
+    T slots[3];
+    alignas(64) int backIndex = 0;   // Writer only
+    alignas(64) int frontIndex = 1;  // Reader only
+    alignas(64) std::atomic<int> middle{2};
+};
@@ -0,0 +1,65 @@
+#pragma once
+#include <array>
+
+// Points on the unit circle at angle 2*pi*i/N, generated at compile time.
+// Every circle and ellipse in the game is one of a handful of segment counts
+// (8, 12, 16, 20), so the trig is folded into constant tables instead of
+// calling cos/sin per vertex.
+//
+//   for (int i = 0; i < 16; i++)
+//       glVertex2f(x + r * UnitCircle<16>::cos[i], y + r * UnitCircle<16>::sin[i]);
+
+namespace unit_circle_detail {
+
+constexpr double PI = 3.14159265358979323846;
+
+// Taylor series, accurate to double precision for |x| <= pi
+constexpr double sinSeries(double x) {
+    double term = x;
+    double sum = x;
+    for (int n = 1; n < 20; ++n) {
+        term *= -x * x / ((2 * n) * (2 * n + 1));
+        sum += term;
+    }
+    return sum;
+}
+
+constexpr double cosSeries(double x) {
+    double term = 1.0;
+    double sum = 1.0;
+    for (int n = 1; n < 20; ++n) {
+        term *= -x * x / ((2 * n - 1) * (2 * n));
+        sum += term;
+    }
+    return sum;
+}
+
+template <int N>
+struct Table {
+    std::array<float, N> cos{};
+    std::array<float, N> sin{};
+};
+
+template <int N>
+constexpr Table<N> buildTable() {
+    Table<N> table;
+    for (int i = 0; i < N; ++i) {
+        double angle = 2.0 * PI * i / N;
+        if (angle > PI) {
+            angle -= 2.0 * PI;
+        }
+        table.cos[i] = static_cast<float>(cosSeries(angle));
+        table.sin[i] = static_cast<float>(sinSeries(angle));
+    }
+    return table;
+}
+
+} // namespace unit_circle_detail
+
+template <int N>
+struct UnitCircle {
+    static constexpr int segments = N;
+    static constexpr unit_circle_detail::Table<N> table = unit_circle_detail::buildTable<N>();
+    static constexpr const std::array<float, N>& cos = table.cos;
+    static constexpr const std::array<float, N>& sin = table.sin;
+};
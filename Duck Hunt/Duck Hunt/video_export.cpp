@@ -0,0 +1,340 @@
+#include "video_export.h"
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstring>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+#ifdef DUCKHUNT_PNG
+#include <png.h>
+#endif
+#ifdef _WIN32
+#include <fcntl.h>
+#include <io.h>
+#endif
+
+enum SlotState {
+    SLOT_FREE,
+    SLOT_FILLING,  // Owned by the drawing thread
+    SLOT_QUEUED,
+    SLOT_ENCODING,
+    SLOT_ENCODED   // Stream formats only: converted, waiting for its turn
+};
+
+struct FrameSlot {
+    std::vector<unsigned char> pixels;   // RGBA, bottom row first
+    std::vector<unsigned char> encoded;  // Stream bytes for this frame
+    long long frame = 0;
+    SlotState state = SLOT_FREE;
+};
+
+static const char* const formatNames[VIDEO_FORMAT_COUNT] = {"png", "y4m", "raw"};
+
+static VideoConfig config;
+static std::vector<FrameSlot> slots;
+static std::vector<std::thread> encoders;
+static int encoderCount = 0;
+static FILE* stream = nullptr;
+
+static std::mutex lock;
+static std::condition_variable slotFreed;
+static std::condition_variable workQueued;
+static std::deque<int> queued;
+static long long nextFrame = 0;  // Next frame handed out by videoFrame()
+static long long nextWrite = 0;  // Next stream frame due to be written
+static long long framesDone = 0;
+static bool writing = false;     // An encoder is writing the stream
+static bool stopping = false;
+static bool failed = false;
+static double waitMs = 0.0;
+static double encodeMs = 0.0;
+
+static double secondsNow() {
+    using namespace std::chrono;
+    return duration<double>(steady_clock::now().time_since_epoch()).count();
+}
+
+int findVideoFormat(const char* name) {
+    for (int i = 0; i < VIDEO_FORMAT_COUNT; ++i) {
+        if (strcmp(name, formatNames[i]) == 0) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+static bool writePng(const FrameSlot& slot) {
+#ifdef DUCKHUNT_PNG
+    char path[1024];
+    snprintf(path, sizeof(path), config.path, static_cast<int>(slot.frame));
+    FILE* file = fopen(path, "wb");
+    if (!file) {
+        fprintf(stderr, "Could not create %s\n", path);
+        return false;
+    }
+    png_structp png = png_create_write_struct(PNG_LIBPNG_VER_STRING, nullptr, nullptr, nullptr);
+    png_infop info = png ? png_create_info_struct(png) : nullptr;
+    if (!info || setjmp(png_jmpbuf(png))) {
+        png_destroy_write_struct(&png, &info);
+        fclose(file);
+        fprintf(stderr, "Could not encode %s\n", path);
+        return false;
+    }
+    png_init_io(png, file);
+    // Speed over size: footage is usually re-encoded anyway
+    png_set_compression_level(png, 1);
+    png_set_IHDR(png, info, config.width, config.height, 8, PNG_COLOR_TYPE_RGB,
+        PNG_INTERLACE_NONE, PNG_COMPRESSION_TYPE_DEFAULT, PNG_FILTER_TYPE_DEFAULT);
+    png_write_info(png, info);
+    // The framebuffer's alpha means nothing on screen, so it is dropped
+    png_set_filler(png, 0, PNG_FILLER_AFTER);
+    size_t stride = static_cast<size_t>(config.width) * 4;
+    for (int y = config.height - 1; y >= 0; --y) {
+        png_write_row(png, const_cast<png_bytep>(&slot.pixels[stride * y]));
+    }
+    png_write_end(png, nullptr);
+    png_destroy_write_struct(&png, &info);
+    return fclose(file) == 0;
+#else
+    return false;
+#endif
+}
+
+static void convertRaw(FrameSlot& slot) {
+    int width = config.width, height = config.height;
+    slot.encoded.resize(static_cast<size_t>(width) * height * 3);
+    unsigned char* out = slot.encoded.data();
+    for (int y = height - 1; y >= 0; --y) {
+        const unsigned char* in = &slot.pixels[static_cast<size_t>(width) * 4 * y];
+        for (int x = 0; x < width; ++x) {
+            out[0] = in[0];
+            out[1] = in[1];
+            out[2] = in[2];
+            out += 3;
+            in += 4;
+        }
+    }
+}
+
+// BT.601 studio range, chroma averaged over each 2x2 block
+static void convertY4m(FrameSlot& slot) {
+    static const char marker[] = "FRAME\n";
+    int width = config.width, height = config.height;
+    size_t lumaSize = static_cast<size_t>(width) * height;
+    size_t chromaSize = lumaSize / 4;
+    size_t header = sizeof(marker) - 1;
+    slot.encoded.resize(header + lumaSize + 2 * chromaSize);
+    memcpy(slot.encoded.data(), marker, header);
+    unsigned char* luma = &slot.encoded[header];
+    unsigned char* cb = luma + lumaSize;
+    unsigned char* cr = cb + chromaSize;
+    size_t stride = static_cast<size_t>(width) * 4;
+
+    for (int y = 0; y < height; y += 2) {
+        const unsigned char* top = &slot.pixels[stride * (height - 1 - y)];
+        const unsigned char* bottom = top - stride;
+        unsigned char* lumaTop = luma + static_cast<size_t>(width) * y;
+        unsigned char* lumaBottom = lumaTop + width;
+        for (int x = 0; x < width; x += 2) {
+            int r = 0, g = 0, b = 0;
+            const unsigned char* quad[4] = {top + 4 * x, top + 4 * x + 4, bottom + 4 * x, bottom + 4 * x + 4};
+            unsigned char* lumaOut[4] = {lumaTop + x, lumaTop + x + 1, lumaBottom + x, lumaBottom + x + 1};
+            for (int i = 0; i < 4; ++i) {
+                int pr = quad[i][0], pg = quad[i][1], pb = quad[i][2];
+                *lumaOut[i] = static_cast<unsigned char>(((66 * pr + 129 * pg + 25 * pb + 128) >> 8) + 16);
+                r += pr;
+                g += pg;
+                b += pb;
+            }
+            r = (r + 2) >> 2;
+            g = (g + 2) >> 2;
+            b = (b + 2) >> 2;
+            *cb++ = static_cast<unsigned char>(((-38 * r - 74 * g + 112 * b + 128) >> 8) + 128);
+            *cr++ = static_cast<unsigned char>(((112 * r - 94 * g - 18 * b + 128) >> 8) + 128);
+        }
+    }
+}
+
+// Writes every converted frame that is next in line. Called with the lock
+// held by the one encoder that set writing; the lock is dropped around
+// each fwrite so the others keep taking work.
+static void writeInOrder(std::unique_lock<std::mutex>& held) {
+    for (;;) {
+        FrameSlot& slot = slots[nextWrite % slots.size()];
+        if (slot.state != SLOT_ENCODED || slot.frame != nextWrite) {
+            return;
+        }
+        held.unlock();
+        bool ok = fwrite(slot.encoded.data(), 1, slot.encoded.size(), stream) == slot.encoded.size();
+        held.lock();
+        failed = failed || !ok;
+        slot.state = SLOT_FREE;
+        nextWrite++;
+        framesDone++;
+        slotFreed.notify_all();
+    }
+}
+
+static void encodeLoop() {
+    std::unique_lock<std::mutex> held(lock);
+    for (;;) {
+        workQueued.wait(held, [] { return stopping || !queued.empty(); });
+        if (queued.empty()) {
+            return;
+        }
+        FrameSlot& slot = slots[queued.front()];
+        queued.pop_front();
+        slot.state = SLOT_ENCODING;
+        held.unlock();
+
+        double begin = secondsNow();
+        bool ok = true;
+        if (config.format == VIDEO_PNG) {
+            ok = writePng(slot);
+        }
+        else if (config.format == VIDEO_Y4M) {
+            convertY4m(slot);
+        }
+        else {
+            convertRaw(slot);
+        }
+        double spent = (secondsNow() - begin) * 1000.0;
+
+        held.lock();
+        encodeMs += spent;
+        failed = failed || !ok;
+        if (config.format == VIDEO_PNG) {
+            slot.state = SLOT_FREE;
+            framesDone++;
+            slotFreed.notify_all();
+            continue;
+        }
+        slot.state = SLOT_ENCODED;
+        if (!writing) {
+            writing = true;
+            writeInOrder(held);
+            writing = false;
+        }
+    }
+}
+
+bool startVideoExport(const VideoConfig& newConfig) {
+    config = newConfig;
+    if (config.format == VIDEO_PNG) {
+#ifndef DUCKHUNT_PNG
+        fprintf(stderr, "Built without libpng, PNG export is not available\n");
+        return false;
+#endif
+        if (!strchr(config.path, '%')) {
+            fprintf(stderr, "PNG export needs a numbered path like frame%%05d.png, not %s\n", config.path);
+            return false;
+        }
+    }
+    else if (config.format == VIDEO_Y4M && (config.width % 2 || config.height % 2)) {
+        fprintf(stderr, "Y4M export needs an even frame size, not %dx%d\n", config.width, config.height);
+        return false;
+    }
+
+    if (config.format != VIDEO_PNG) {
+        if (strcmp(config.path, "-") == 0) {
+#ifdef _WIN32
+            _setmode(_fileno(stdout), _O_BINARY);
+#endif
+            stream = stdout;
+        }
+        else {
+            stream = fopen(config.path, "wb");
+        }
+        if (!stream) {
+            fprintf(stderr, "Could not create %s\n", config.path);
+            return false;
+        }
+        if (config.format == VIDEO_Y4M) {
+            fprintf(stream, "YUV4MPEG2 W%d H%d F%d:1 Ip A1:1 C420jpeg\n", config.width, config.height, config.fps);
+        }
+    }
+
+    int threads = config.encoders;
+    if (threads <= 0) {
+        threads = static_cast<int>(std::thread::hardware_concurrency());
+        threads = threads > 0 ? threads : 1;
+    }
+    int slotCount = config.queueFrames > 0 ? config.queueFrames : 2 * threads;
+    slots.assign(slotCount, FrameSlot());
+    for (FrameSlot& slot : slots) {
+        slot.pixels.resize(static_cast<size_t>(config.width) * config.height * 4);
+    }
+    queued.clear();
+    nextFrame = nextWrite = framesDone = 0;
+    writing = stopping = failed = false;
+    waitMs = encodeMs = 0.0;
+    encoderCount = threads;
+    for (int i = 0; i < threads; ++i) {
+        encoders.emplace_back(encodeLoop);
+    }
+    return true;
+}
+
+unsigned char* videoFrame() {
+    std::unique_lock<std::mutex> held(lock);
+    FrameSlot& slot = slots[nextFrame % slots.size()];
+    if (slot.state == SLOT_FILLING) {
+        return slot.pixels.data();
+    }
+    if (slot.state != SLOT_FREE) {
+        double begin = secondsNow();
+        slotFreed.wait(held, [&] { return slot.state == SLOT_FREE; });
+        waitMs += (secondsNow() - begin) * 1000.0;
+    }
+    slot.state = SLOT_FILLING;
+    slot.frame = nextFrame;
+    return slot.pixels.data();
+}
+
+void submitVideoFrame() {
+    {
+        std::lock_guard<std::mutex> held(lock);
+        int index = static_cast<int>(nextFrame % slots.size());
+        slots[index].state = SLOT_QUEUED;
+        queued.push_back(index);
+        nextFrame++;
+    }
+    workQueued.notify_one();
+}
+
+bool finishVideoExport() {
+    {
+        std::unique_lock<std::mutex> held(lock);
+        slotFreed.wait(held, [] { return framesDone == nextFrame; });
+        stopping = true;
+    }
+    workQueued.notify_all();
+    for (std::thread& encoder : encoders) {
+        encoder.join();
+    }
+    encoders.clear();
+
+    if (stream) {
+        failed = failed || fflush(stream) != 0;
+        if (stream != stdout) {
+            failed = failed || fclose(stream) != 0;
+        }
+        stream = nullptr;
+    }
+    if (failed) {
+        fprintf(stderr, "Some frames could not be written\n");
+    }
+    return !failed;
+}
+
+VideoStats videoStats() {
+    std::lock_guard<std::mutex> held(lock);
+    VideoStats stats;
+    stats.frames = framesDone;
+    stats.waitMs = waitMs;
+    stats.encodeMs = encodeMs;
+    stats.encoders = encoderCount;
+    return stats;
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+// Frames handed over by a drawing thread and encoded by a pool of encoder
+// threads. Frames wait in a fixed ring of slots: the drawing thread fills a
+// free slot, any idle encoder converts it, and the drawing thread only ever
+// waits when every slot is still busy. PNG frames go to files of their own
+// in whatever order they finish; stream formats are converted in parallel
+// and written strictly in frame order.
+enum VideoFormat {
+    VIDEO_PNG,  // One file per frame, path is a printf pattern like "frame%05d.png"
+    VIDEO_Y4M,  // YUV4MPEG2 4:2:0 stream, readable by ffmpeg and most players
+    VIDEO_RAW,  // Bare rgb24 frames, top row first
+    VIDEO_FORMAT_COUNT
+};
+
+struct VideoConfig {
+    VideoFormat format = VIDEO_Y4M;
+    const char* path = nullptr;  // "-" writes streams to stdout
+    int width = 0;
+    int height = 0;
+    int fps = 60;
+    int encoders = 0;            // <= 0 uses one per hardware thread
+    int queueFrames = 0;         // Slots; <= 0 uses two per encoder
+};
+
+// Returns the VideoFormat called name ("png", "y4m", "raw"), or -1.
+int findVideoFormat(const char* name);
+
+// Returns false and prints why if the output cannot be opened or the
+// format is not built in.
+bool startVideoExport(const VideoConfig& config);
+
+// The next frame's slot, width * height RGBA pixels bottom row first like
+// the GL framebuffer. Waits while every slot is busy. Until the slot is
+// submitted, calling again returns the same one.
+unsigned char* videoFrame();
+
+// Hands the slot from videoFrame() to the encoders.
+void submitVideoFrame();
+
+// Waits for every submitted frame to be written and stops the encoders.
+// Returns false if any frame failed to write.
+bool finishVideoExport();
+
+struct VideoStats {
+    long long frames = 0;      // Written
+    double waitMs = 0.0;       // Drawing thread blocked on a full ring
+    double encodeMs = 0.0;     // Summed over the encoders
+    int encoders = 0;
+};
+
+VideoStats videoStats();
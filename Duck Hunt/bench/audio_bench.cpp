@@ -0,0 +1,57 @@
+// Click-to-mix latency of the audio engine: fires the gunshot at a steady
+// rate from this thread, as the game's input handler would, and reports how
+// long playSound() took and how long each shot waited for its block. With
+// a path, the mix is written to a WAV file to listen to afterwards.
+//
+//   duckhunt_audio_bench [seconds] [shots per second] [block frames] [out.wav]
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+#include "audio.h"
+
+int main(int argc, char** argv) {
+    double seconds = argc > 1 ? atof(argv[1]) : 3.0;
+    double rate = argc > 2 ? atof(argv[2]) : 20.0;
+    AudioConfig config;
+    config.output = AUDIO_NULL;
+    config.blockFrames = argc > 3 ? atoi(argv[3]) : config.blockFrames;
+    if (argc > 4) {
+        config.output = AUDIO_WAV_FILE;
+        config.wavPath = argv[4];
+    }
+
+    Sound gunshot;
+    synthesizeGunshot(config.rate, gunshot);
+    if (!startAudio(config, &gunshot, 1)) {
+        return 1;
+    }
+
+    using namespace std::chrono;
+    int shots = static_cast<int>(seconds * rate);
+    nanoseconds interval(static_cast<long long>(1e9 / rate));
+    steady_clock::time_point next = steady_clock::now();
+    double callTotalNs = 0.0, callMaxNs = 0.0;
+    for (int shot = 0; shot < shots; ++shot) {
+        next += interval;
+        std::this_thread::sleep_until(next);
+        steady_clock::time_point begin = steady_clock::now();
+        playSound(0);
+        double ns = duration<double, std::nano>(steady_clock::now() - begin).count();
+        callTotalNs += ns;
+        callMaxNs = std::max(callMaxNs, ns);
+    }
+    // Let the last shot ring out
+    std::this_thread::sleep_for(milliseconds(300));
+    stopAudio();
+
+    AudioStats stats = audioStats();
+    printf("block:        %d frames, %.2f ms\n", config.blockFrames, 1000.0 * config.blockFrames / config.rate);
+    printf("shots:        %d fired, %lld started, %lld dropped, %lld voices stolen\n",
+        shots, stats.voicesStarted, stats.commandsDropped, stats.voicesStolen);
+    printf("playSound():  mean %.0f ns, max %.0f ns\n", shots > 0 ? callTotalNs / shots : 0.0, callMaxNs);
+    printf("to output:    mean %.2f ms, max %.2f ms\n", stats.latencyMeanMs, stats.latencyMaxMs);
+    printf("blocks:       %lld mixed, %lld late\n", stats.blocks, stats.lateBlocks);
+    return 0;
+}
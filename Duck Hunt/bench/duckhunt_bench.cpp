@@ -0,0 +1,221 @@
+// Baseline suite for performance work, on Google Benchmark so results can be
+// kept as JSON and compared run to run:
+//
+//   duckhunt_bench --benchmark_out=baseline.json --benchmark_out_format=json
+//   compare.py benchmarks baseline.json new.json   (from Google Benchmark)
+//
+// Covers the duck update of one tick, the shot hit test, the score popup
+// update and, where EGL can give a surfaceless context, a whole frame drawn
+// offscreen by the game's own scene code and by the software rasterizer.
+#include <benchmark/benchmark.h>
+#include <vector>
+#include "simulation.h"
+#include "replay.h"
+
+#ifdef DUCKHUNT_BENCH_FRAME
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+#include "gl_ext.h"
+#include "duck_renderer.h"
+#include "frame.h"
+#include "soft_renderer.h"
+#include "text_renderer.h"
+#endif
+
+// A world of the given mode, flown for a while so the flock has spread
+static void startWorld(World& world, int mode, int ducks) {
+    InputLog start;
+    start.mode = mode;
+    start.seed = 1;
+    start.maxDucks = ducks;
+    startFromLog(world, start);
+    for (int tick = 0; tick < 300; ++tick) {
+        stepWorld(world, SIM_STEP);
+    }
+}
+
+// One tick of duck movement and top-up, as the game's timer runs it
+static void BM_StepWorld(benchmark::State& state) {
+    World world;
+    startWorld(world, static_cast<int>(state.range(0)), static_cast<int>(state.range(1)));
+    for (auto _ : state) {
+        // Keep the clock from ending the game, which would stop the ducks
+        world.timeRemaining = ClassicRules::GAME_DURATION;
+        stepWorld(world, SIM_STEP);
+    }
+    state.SetItemsProcessed(state.iterations() * world.ducks.count);
+    state.counters["ducks"] = world.ducks.count;
+}
+BENCHMARK(BM_StepWorld)
+    ->ArgNames({"mode", "ducks"})
+    ->Args({MODE_CLASSIC, 0})
+    ->Args({MODE_SWARM, 0})
+    ->Args({MODE_STRESS, 1000})
+    ->Args({MODE_STRESS, 10000});
+
+// The hit test behind every click, at random points so most shots miss and
+// have to look at every candidate
+static void BM_HitTest(benchmark::State& state) {
+    int size = static_cast<int>(state.range(0));
+    Pcg32 rng;
+    seedRandom(rng, 1, 1);
+    DuckPool ducks;
+    reserveDucks(ducks, size);
+    for (int i = 0; i < size; ++i) {
+        float x = WINDOW_WIDTH * randomFloat(rng);
+        float y = WINDOW_HEIGHT / 3.5f + (WINDOW_HEIGHT - WINDOW_HEIGHT / 3.5f) * randomFloat(rng);
+        addDuck(ducks, x, y, 1.0f, 0.0f, 0, 0);
+    }
+
+    const int queries = 4096;
+    std::vector<float> points(2 * queries);
+    for (float& point : points) {
+        point = randomFloat(rng);
+    }
+    float radius = static_cast<float>(ClassicRules::SHOT_RADIUS + DUCK_SIZE);
+    int q = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(findDuckAt(ducks, points[2 * q] * WINDOW_WIDTH, points[2 * q + 1] * WINDOW_HEIGHT, radius));
+        q = (q + 1) & (queries - 1);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_HitTest)->ArgName("ducks")->Arg(3)->Arg(100)->Arg(1000)->Arg(10000);
+
+// A tick with the screen full of score popups and nothing else moving
+static void BM_FloatingTexts(benchmark::State& state) {
+    World world;
+    startWorld(world, MODE_CLASSIC, 0);
+    world.gameOver = true;  // Popups still drift, the ducks stop
+    for (auto _ : state) {
+        while (world.floatingTexts.size() < MAX_FLOATING_TEXTS) {
+            addFloatingText(world, 400.0f, 300.0f, 500);
+        }
+        stepWorld(world, SIM_STEP);
+    }
+    state.SetItemsProcessed(state.iterations() * MAX_FLOATING_TEXTS);
+}
+BENCHMARK(BM_FloatingTexts);
+
+#ifdef DUCKHUNT_BENCH_FRAME
+static GlProc eglProc(const char* name) {
+    return reinterpret_cast<GlProc>(eglGetProcAddress(name));
+}
+
+// A filled box per glyph: the atlas path costs the same whatever the font
+static void drawBoxGlyph(int /*font*/, char /*c*/) {
+    static const GLubyte rows[12] = {0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF};
+    glBitmap(8, 12, 0, 0, 9, 0, rows);
+}
+
+static int boxGlyphAdvance(int /*font*/, char /*c*/) {
+    return 9;
+}
+
+static int boxLineHeight(int font) {
+    return font == TEXT_HELVETICA_18 ? 22 : 15;
+}
+
+// A WINDOW_WIDTH x WINDOW_HEIGHT pbuffer on a surfaceless display, set up
+// the way the game's reshape() leaves its window. Made once per process.
+static bool offscreenContext() {
+    static int ready = -1;
+    if (ready >= 0) {
+        return ready == 1;
+    }
+    ready = 0;
+
+    PFNEGLGETPLATFORMDISPLAYEXTPROC getPlatformDisplay =
+        reinterpret_cast<PFNEGLGETPLATFORMDISPLAYEXTPROC>(eglGetProcAddress("eglGetPlatformDisplayEXT"));
+    EGLDisplay display = getPlatformDisplay ? getPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, nullptr) : EGL_NO_DISPLAY;
+    EGLint major, minor;
+    if (display == EGL_NO_DISPLAY || !eglInitialize(display, &major, &minor) || !eglBindAPI(EGL_OPENGL_API)) {
+        return false;
+    }
+    const EGLint configAttributes[] = {
+        EGL_SURFACE_TYPE, EGL_PBUFFER_BIT, EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT,
+        EGL_RED_SIZE, 8, EGL_GREEN_SIZE, 8, EGL_BLUE_SIZE, 8, EGL_NONE
+    };
+    const EGLint surfaceAttributes[] = {EGL_WIDTH, WINDOW_WIDTH, EGL_HEIGHT, WINDOW_HEIGHT, EGL_NONE};
+    EGLConfig config;
+    EGLint configs = 0;
+    if (!eglChooseConfig(display, configAttributes, &config, 1, &configs) || configs == 0) {
+        return false;
+    }
+    EGLSurface surface = eglCreatePbufferSurface(display, config, surfaceAttributes);
+    EGLContext context = eglCreateContext(display, config, EGL_NO_CONTEXT, nullptr);
+    if (surface == EGL_NO_SURFACE || context == EGL_NO_CONTEXT || !eglMakeCurrent(display, surface, surface, context)) {
+        return false;
+    }
+
+    glViewport(0, 0, WINDOW_WIDTH, WINDOW_HEIGHT);
+    glMatrixMode(GL_PROJECTION);
+    glLoadIdentity();
+    glOrtho(0, WINDOW_WIDTH, 0, WINDOW_HEIGHT, -1, 1);
+    glMatrixMode(GL_MODELVIEW);
+    initDuckRenderer(eglProc);
+    initTextRenderer({drawBoxGlyph, boxGlyphAdvance, boxLineHeight});
+    ready = 1;
+    return true;
+}
+
+// What display() draws, finished on the GPU before the clock stops
+static void BM_Frame(benchmark::State& state) {
+    if (!offscreenContext()) {
+        state.SkipWithError("no surfaceless EGL context");
+        return;
+    }
+    World world;
+    startWorld(world, static_cast<int>(state.range(0)), static_cast<int>(state.range(1)));
+    for (int i = 0; i < 8; ++i) {
+        addFloatingText(world, 100.0f + 80.0f * i, 300.0f, 500);
+    }
+    for (auto _ : state) {
+        glClear(GL_COLOR_BUFFER_BIT);
+        drawScene(world, 0.5f);
+        drawCrosshair(world.pointerX, world.pointerY);
+        glFinish();
+    }
+    const DuckDrawStats& ducks = duckDrawStats();
+    state.counters["draw_calls"] = ducks.drawCalls;
+    state.counters["ducks"] = world.ducks.count;
+}
+BENCHMARK(BM_Frame)
+    ->ArgNames({"mode", "ducks"})
+    ->Args({MODE_CLASSIC, 0})
+    ->Args({MODE_STRESS, 10000})
+    ->Unit(benchmark::kMillisecond);
+
+// The same frame from the software rasterizer, up to the finished
+// framebuffer; the GL context only supplies the glyph atlas
+static void BM_SoftFrame(benchmark::State& state) {
+    if (!offscreenContext()) {
+        state.SkipWithError("no surfaceless EGL context");
+        return;
+    }
+    World world;
+    startWorld(world, static_cast<int>(state.range(0)), static_cast<int>(state.range(1)));
+    for (int i = 0; i < 8; ++i) {
+        addFloatingText(world, 100.0f + 80.0f * i, 300.0f, 500);
+    }
+    initSoftRenderer(static_cast<int>(state.range(2)));
+    for (auto _ : state) {
+        softDrawScene(world, 0.5f);
+        softDrawCrosshair(world.pointerX, world.pointerY);
+        benchmark::DoNotOptimize(softFramebuffer());
+    }
+    shutdownSoftRenderer();
+    state.counters["ducks"] = world.ducks.count;
+    state.counters["fps"] = benchmark::Counter(static_cast<double>(state.iterations()), benchmark::Counter::kIsRate);
+}
+BENCHMARK(BM_SoftFrame)
+    ->ArgNames({"mode", "ducks", "threads"})
+    ->Args({MODE_CLASSIC, 0, 1})
+    ->Args({MODE_CLASSIC, 0, 0})
+    ->Args({MODE_STRESS, 10000, 1})
+    ->Args({MODE_STRESS, 10000, 0})
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+#endif
+
+BENCHMARK_MAIN();
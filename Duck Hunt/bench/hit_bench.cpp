@@ -0,0 +1,86 @@
+// Shot resolution cost against flock size: the old linear scan with a sqrt
+// per duck against findDuckAt() on the uniform grid. Ducks are spread over
+// the band they fly in and every query is a random point in the window, so
+// most shots miss and have to look at every candidate.
+//
+//   duckhunt_hit_bench [queries]
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include "simulation.h"
+
+static int sink = 0;
+
+static int linearScan(const DuckPool& ducks, float x, float y) {
+    for (int i = 0; i < ducks.count; ++i) {
+        if (ducks.alive[i]) {
+            float dx = ducks.x[i] - x;
+            float dy = ducks.y[i] - y;
+            if (sqrt(dx * dx + dy * dy) < ClassicRules::SHOT_RADIUS + DUCK_SIZE) {
+                return i;
+            }
+        }
+    }
+    return -1;
+}
+
+static Pcg32 rng;
+
+static float randomIn(float low, float high) {
+    return low + (high - low) * randomFloat(rng);
+}
+
+template <bool Grid>
+static double nsPerQuery(const DuckPool& ducks, const float* points, int queries) {
+    auto start = std::chrono::steady_clock::now();
+    for (int q = 0; q < queries; ++q) {
+        float x = points[2 * q];
+        float y = points[2 * q + 1];
+        sink += Grid ? findDuckAt(ducks, x, y, static_cast<float>(ClassicRules::SHOT_RADIUS + DUCK_SIZE)) : linearScan(ducks, x, y);
+    }
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::nano>(end - start).count() / queries;
+}
+
+int main(int argc, char** argv) {
+    int queries = argc > 1 ? atoi(argv[1]) : 20000;
+    const int sizes[] = {3, 100, 1000, 10000, 100000};
+
+    seedRandom(rng, 1, 1);
+    float* points = new float[2 * queries];
+    for (int q = 0; q < queries; ++q) {
+        points[2 * q] = randomIn(0.0f, WINDOW_WIDTH);
+        points[2 * q + 1] = randomIn(0.0f, WINDOW_HEIGHT);
+    }
+
+    printf("%8s %14s %14s %8s\n", "ducks", "linear ns", "grid ns", "hits");
+    for (int size : sizes) {
+        DuckPool ducks;
+        reserveDucks(ducks, size);
+        for (int i = 0; i < size; ++i) {
+            addDuck(ducks, randomIn(0.0f, WINDOW_WIDTH), randomIn(WINDOW_HEIGHT / 3.5f, WINDOW_HEIGHT), 1.0f, 0.0f, 0, 0);
+        }
+
+        // Both must agree on whether a shot hits; with overlapping ducks
+        // they may pick different ones
+        int hits = 0;
+        for (int q = 0; q < queries; ++q) {
+            bool expected = linearScan(ducks, points[2 * q], points[2 * q + 1]) != -1;
+            bool found = findDuckAt(ducks, points[2 * q], points[2 * q + 1], static_cast<float>(ClassicRules::SHOT_RADIUS + DUCK_SIZE)) != -1;
+            if (found != expected) {
+                printf("mismatch at %d ducks\n", size);
+                return 1;
+            }
+            hits += expected;
+        }
+
+        int linearQueries = size >= 10000 ? queries / 20 : queries;
+        double linear = nsPerQuery<false>(ducks, points, linearQueries);
+        double grid = nsPerQuery<true>(ducks, points, queries);
+        printf("%8d %14.1f %14.1f %8d\n", size, linear, grid, hits);
+    }
+
+    delete[] points;
+    return sink == 12345 ? 1 : 0;
+}
@@ -0,0 +1,200 @@
+// Hit rate of a perfect shooter under frame jitter, with shots tested
+// against the ducks as they are when the shot lands and against the ducks
+// rewound to the frame the shooter saw. Each trial shows an interpolated
+// frame and aims at a random point that would count as a hit on one duck
+// as drawn, then lets a random delay of up to the jitter pass before the
+// shot lands, as a slow frame plus the display's latency would. Also
+// prints what the position history costs in memory and per shot, the
+// latter against a pass over every duck that also checks the grid search.
+//
+//   duckhunt_lag_bench [trials per row] [seed]
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include "replay.h"
+
+struct Tally {
+    int current = 0;
+    int rewound = 0;
+};
+
+static bool hits(const World& world, float x, float y, float rewind) {
+    World copy = world;
+    int missed = copy.missedShots;
+    handleShot(copy, x, y, rewind);
+    return copy.missedShots == missed;
+}
+
+// findDuckAtPast() without the grid: every duck, blended the same way
+static int scanPast(const DuckPool& pool, float x, float y, float radius, float rewind) {
+    int back = static_cast<int>(rewind);
+    float blend = rewind - static_cast<float>(back);
+    size_t stride = pool.x.size();
+    size_t newer = static_cast<size_t>((pool.historyTick - back) % DUCK_HISTORY) * stride;
+    size_t older = static_cast<size_t>((pool.historyTick - back - 1 + DUCK_HISTORY) % DUCK_HISTORY) * stride;
+    int best = -1;
+    float bestDistance = radius * radius;
+    for (int i = 0; i < pool.count; ++i) {
+        int depth = pool.historyDepth[i];
+        if (!pool.alive[i] || depth <= back) {
+            continue;
+        }
+        float px = pool.historyX[newer + i];
+        float py = pool.historyY[newer + i];
+        if (blend > 0.0f && depth > back + 1) {
+            px += (pool.historyX[older + i] - px) * blend;
+            py += (pool.historyY[older + i] - py) * blend;
+        }
+        float dx = px - x;
+        float dy = py - y;
+        float distance = dx * dx + dy * dy;
+        if (distance < bestDistance) {
+            bestDistance = distance;
+            best = i;
+        }
+    }
+    return best;
+}
+
+static int sink = 0;
+
+template <typename Find>
+static double nsPerShot(const float* points, int shots, Find find) {
+    auto start = std::chrono::steady_clock::now();
+    for (int q = 0; q < shots; ++q) {
+        sink += find(points[2 * q], points[2 * q + 1]);
+    }
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::nano>(end - start).count() / shots;
+}
+
+static Tally runTrials(int mode, float radius, double jitterMs, int trials, Pcg32& rng) {
+    InputLog start;
+    start.seed = 7;
+    start.mode = mode;
+    World world;
+    startFromLog(world, start);
+
+    Tally tally;
+    for (int trial = 0; trial < trials; ++trial) {
+        if (world.gameOver || world.roundOver || world.timeRemaining < 5) {
+            initWorld(world);
+        }
+        // Rounds never run out of shots here
+        world.shotsRemaining = 1000;
+        int settle = 5 + randomBelow(rng, 30);
+        for (int i = 0; i < settle; ++i) {
+            stepWorld(world, SIM_STEP);
+        }
+        if (world.ducks.count == 0) {
+            trial--;
+            continue;
+        }
+
+        // The frame on screen and the duck aimed at in it
+        const DuckPool& ducks = world.ducks;
+        float alpha = randomFloat(rng);
+        int target = randomBelow(rng, ducks.count);
+        float x = ducks.prevX[target] + (ducks.x[target] - ducks.prevX[target]) * alpha;
+        float y = ducks.prevY[target] + (ducks.y[target] - ducks.prevY[target]) * alpha;
+        // Anywhere inside the hit circle, short of its edge
+        float angle = 6.2831853f * randomFloat(rng);
+        float reach = 0.95f * radius * sqrtf(randomFloat(rng));
+        x += reach * cosf(angle);
+        y += reach * sinf(angle);
+        double shownTick = static_cast<double>(world.tick) - 1.0 + alpha;
+
+        // The world keeps ticking until the shot lands
+        double landsAt = shownTick + jitterMs / 1000.0 * randomFloat(rng) / SIM_STEP;
+        while (world.tick + 1 <= landsAt) {
+            stepWorld(world, SIM_STEP);
+        }
+        if (world.gameOver) {
+            trial--;
+            continue;
+        }
+        float rewind = static_cast<float>(world.tick - shownTick);
+        int quantized = static_cast<int>(rewind / REWIND_UNIT + 0.5f);
+        tally.current += hits(world, x, y, 0.0f);
+        tally.rewound += hits(world, x, y, quantized * REWIND_UNIT);
+    }
+    return tally;
+}
+
+int main(int argc, char** argv) {
+    int trials = argc > 1 ? atoi(argv[1]) : 20000;
+    uint64_t seed = argc > 2 ? strtoull(argv[2], nullptr, 10) : 1;
+    static const double jitters[] = {0.0, 8.0, 16.0, 33.0, 50.0, 100.0};
+    static const int modes[] = {MODE_CLASSIC, MODE_SWARM, MODE_SNIPER};
+    static const float radii[] = {
+        ClassicRules::SHOT_RADIUS + DUCK_SIZE, SwarmRules::SHOT_RADIUS + DUCK_SIZE, SniperRules::SHOT_RADIUS + DUCK_SIZE
+    };
+
+    printf("%-8s %10s %12s %12s\n", "mode", "jitter ms", "current", "rewound");
+    bool improved = true;
+    for (int m = 0; m < 3; ++m) {
+        int mode = modes[m];
+        for (double jitter : jitters) {
+            Pcg32 rng;
+            seedRandom(rng, seed, 1);
+            Tally tally = runTrials(mode, radii[m], jitter, trials, rng);
+            printf("%-8s %10.0f %11.1f%% %11.1f%%\n", gameMode(mode).name, jitter,
+                100.0 * tally.current / trials, 100.0 * tally.rewound / trials);
+            improved = improved && tally.rewound >= tally.current;
+        }
+    }
+
+    printf("\nhistory: %d ticks (%.0f ms) of positions per duck\n", DUCK_HISTORY, DUCK_HISTORY * SIM_STEP * 1000.0);
+    for (int mode = 0; mode < MODE_COUNT; ++mode) {
+        InputLog start;
+        start.mode = mode;
+        World world;
+        startFromLog(world, start);
+        printf("%-8s %5d ducks  %8.1f KiB\n", gameMode(mode).name, world.ducks.capacity,
+            duckHistoryBytes(world.ducks) / 1024.0);
+    }
+
+    // A full sky, a shot anywhere in the window, rewound most of the history
+    const int shots = 20000;
+    const float rewind = DUCK_HISTORY - 1.5f;
+    Pcg32 rng;
+    seedRandom(rng, seed, 2);
+    float* points = new float[2 * shots];
+    for (int q = 0; q < shots; ++q) {
+        points[2 * q] = WINDOW_WIDTH * randomFloat(rng);
+        points[2 * q + 1] = WINDOW_HEIGHT * randomFloat(rng);
+    }
+    printf("\n%-8s %6s %12s %12s %12s\n", "mode", "ducks", "current ns", "rewound ns", "scan ns");
+    static const int costModes[] = {MODE_CLASSIC, MODE_SWARM, MODE_STRESS};
+    static const float costRadii[] = {
+        ClassicRules::SHOT_RADIUS + DUCK_SIZE, SwarmRules::SHOT_RADIUS + DUCK_SIZE, StressRules::SHOT_RADIUS + DUCK_SIZE
+    };
+    bool agreed = true;
+    for (int m = 0; m < 3; ++m) {
+        int mode = costModes[m];
+        InputLog start;
+        start.mode = mode;
+        World world;
+        startFromLog(world, start);
+        for (int i = 0; i < 200; ++i) {
+            stepWorld(world, SIM_STEP);
+        }
+        const DuckPool& ducks = world.ducks;
+        float radius = costRadii[m];
+        for (int q = 0; q < shots; ++q) {
+            float x = points[2 * q];
+            float y = points[2 * q + 1];
+            agreed = agreed && findDuckAtPast(ducks, x, y, radius, rewind) == scanPast(ducks, x, y, radius, rewind);
+        }
+        double current = nsPerShot(points, shots, [&](float x, float y) { return findDuckAt(ducks, x, y, radius); });
+        double rewound = nsPerShot(points, shots, [&](float x, float y) { return findDuckAtPast(ducks, x, y, radius, rewind); });
+        double scan = nsPerShot(points, shots, [&](float x, float y) { return scanPast(ducks, x, y, radius, rewind); });
+        printf("%-8s %6d %12.1f %12.1f %12.1f\n", gameMode(mode).name, ducks.count, current, rewound, scan);
+    }
+    delete[] points;
+    if (!agreed) {
+        printf("grid and scan picked different ducks\n");
+    }
+    return improved && agreed && sink != 12345 ? 0 : 1;
+}
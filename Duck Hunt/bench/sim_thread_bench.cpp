@@ -0,0 +1,95 @@
+// Tick steadiness of the simulation thread under a stalling renderer: the
+// bot plays on the simulation thread while this thread takes snapshots as
+// a frame loop would, posts shots and motion, and every so often stalls for
+// a whole slow frame. Each snapshot is checked to be a consistent world.
+// Build with -DDUCKHUNT_TSAN=ON to have ThreadSanitizer watch the handoff.
+//
+//   duckhunt_sim_thread_bench [seconds] [stall ms] [mode] [ducks]
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+#include "sim_thread.h"
+
+static double secondsNow() {
+    using namespace std::chrono;
+    return duration<double>(steady_clock::now().time_since_epoch()).count();
+}
+
+// What the renderer relies on: packed live ducks with finite positions
+static bool consistent(const World& world) {
+    const DuckPool& ducks = world.ducks;
+    if (ducks.count < 0 || ducks.count > ducks.capacity) {
+        return false;
+    }
+    for (int i = 0; i < ducks.count; ++i) {
+        if (!std::isfinite(ducks.x[i]) || !std::isfinite(ducks.y[i]) || !std::isfinite(ducks.prevX[i])) {
+            return false;
+        }
+    }
+    return world.floatingTexts.size() <= MAX_FLOATING_TEXTS;
+}
+
+int main(int argc, char** argv) {
+    double seconds = argc > 1 ? atof(argv[1]) : 5.0;
+    double stallMs = argc > 2 ? atof(argv[2]) : 100.0;
+    InputLog start;
+    start.seed = 1;
+    start.mode = MODE_CLASSIC;
+    if (argc > 3 && findGameMode(argv[3]) != -1) {
+        start.mode = findGameMode(argv[3]);
+    }
+    start.maxDucks = argc > 4 ? atoi(argv[4]) : 0;
+
+    static SimThread sim;
+    static Bot bot;
+    startFromLog(sim.world, start);
+    sim.loop.bot = &bot;
+    startSimThread(sim, secondsNow);
+
+    Pcg32 rng;
+    seedRandom(rng, 2, 1);
+    long long frames = 0, snapshots = 0, skipped = 0, broken = 0, stalls = 0;
+    long long lastTick = simSnapshot(sim).world.tick;
+    double begin = secondsNow();
+    double nextStall = begin + 0.5;
+    while (secondsNow() - begin < seconds) {
+        if (takeSimSnapshot(sim)) {
+            const World& world = simSnapshot(sim).world;
+            snapshots++;
+            if (world.tick < lastTick || !consistent(world)) {
+                broken++;
+            }
+            skipped += world.tick > lastTick + 1 ? world.tick - lastTick - 1 : 0;
+            lastTick = world.tick;
+            worldChecksum(world);  // Reads every duck, as drawing would
+        }
+        int x = static_cast<int>(WINDOW_WIDTH * randomFloat(rng));
+        int y = static_cast<int>(WINDOW_HEIGHT * randomFloat(rng));
+        postSimInput(sim, randomFloat(rng) < 0.05f ? INPUT_SHOT : INPUT_MOTION, x, y);
+        frames++;
+
+        double now = secondsNow();
+        if (now >= nextStall) {
+            std::this_thread::sleep_for(std::chrono::duration<double>(stallMs / 1000.0));
+            stalls++;
+            nextStall = now + 0.5;
+        }
+        else {
+            std::this_thread::sleep_for(std::chrono::microseconds(4000));
+        }
+    }
+    double elapsed = secondsNow() - begin;
+    stopSimThread(sim);
+
+    SimStats stats = simStats(sim);
+    printf("ran:        %.2f s, %d renderer stalls of %.0f ms\n", elapsed, static_cast<int>(stalls), stallMs);
+    printf("ticks:      %lld, %.1f per second (%.1f expected)\n", stats.ticks, stats.ticks / elapsed, 1.0 / SIM_STEP);
+    printf("passes:     %lld, %lld caught up on missed ticks\n", stats.passes, stats.catchUpPasses);
+    printf("wake:       %.3f ms late on average, %.3f ms at worst\n", stats.meanLateMs, stats.maxLateMs);
+    printf("renderer:   %lld frames, %lld snapshots, %lld ticks never seen, %lld inconsistent\n",
+        frames, snapshots, skipped, broken);
+    printf("input:      %lld dropped\n", stats.inputDropped);
+    return broken == 0 ? 0 : 1;
+}
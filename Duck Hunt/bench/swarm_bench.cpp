@@ -0,0 +1,50 @@
+// Simulation cost against flock size in the stress mode: ticks with every
+// slot topped up in batches, plus a shot every 30 ticks. Together with the
+// game's profiler (duckhunt --mode stress --bot --profile-csv PATH) for the
+// renderer, this is the scalability benchmark.
+//
+//   duckhunt_swarm_bench [ticks] [spawn rate]
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include "simulation.h"
+#include "replay.h"
+
+int main(int argc, char** argv) {
+    int ticks = argc > 1 ? atoi(argv[1]) : 2000;
+    int spawnsPerTick = argc > 2 ? atoi(argv[2]) : 0;
+    const int sizes[] = {1000, 2500, 5000, 10000, 20000, 50000};
+    const int warmup = 300;  // Long enough for the first flock to spread out
+
+    printf("%8s %12s %12s %12s %12s\n", "ducks", "us/tick", "ns/duck", "spawns/tick", "ticks/sec");
+    for (int size : sizes) {
+        InputLog start;
+        start.mode = MODE_STRESS;
+        start.seed = 1;
+        start.maxDucks = size;
+        start.spawnsPerTick = spawnsPerTick;
+        World world;
+        startFromLog(world, start);
+        for (int tick = 0; tick < warmup; ++tick) {
+            stepWorld(world, SIM_STEP);
+        }
+
+        int spawns = world.ducks.stats.spawns;
+        auto begin = std::chrono::steady_clock::now();
+        for (int tick = 0; tick < ticks; ++tick) {
+            stepWorld(world, SIM_STEP);
+            if (tick % 30 == 0 && world.ducks.count > 0) {
+                int x = static_cast<int>(world.ducks.x[0] + 0.5f);
+                int y = static_cast<int>(world.ducks.y[0] + 0.5f);
+                submitInput(world, nullptr, INPUT_SHOT, x, y);
+            }
+        }
+        auto end = std::chrono::steady_clock::now();
+
+        double seconds = std::chrono::duration<double>(end - begin).count();
+        double perTick = seconds / ticks;
+        printf("%8d %12.1f %12.2f %12.1f %12.0f\n", size, perTick * 1e6, perTick * 1e9 / size,
+            static_cast<double>(world.ducks.stats.spawns - spawns) / ticks, 1.0 / perTick);
+    }
+    return 0;
+}
@@ -0,0 +1,90 @@
+// Per-frame trig cost of the game's circles: runtime cos/sin (what the draw
+// functions did before) against the constexpr UnitCircle tables.
+//
+// One frame used to generate every circle vertex from scratch: per duck a
+// 20-segment body, 16-segment head, 12-segment eye and 8-segment pupil, plus
+// four 12-segment leaves, the 12-segment bush and the 16-segment crosshair.
+//
+//   duckhunt_trig_bench [ducks] [frames]
+#define _USE_MATH_DEFINES
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include "unit_circle.h"
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+static float sink = 0.0f;
+
+template <int N>
+static float circleRuntime(float cx, float cy, float r) {
+    float sum = 0.0f;
+    for (int i = 0; i < N; i++) {
+        float angle = 2.0f * M_PI * i / N;
+        float x = cx + r * cos(angle);
+        float y = cy + r * sin(angle);
+        sum += x + y;
+    }
+    return sum;
+}
+
+template <int N>
+static float circleTable(float cx, float cy, float r) {
+    float sum = 0.0f;
+    for (int i = 0; i < N; i++) {
+        float x = cx + r * UnitCircle<N>::cos[i];
+        float y = cy + r * UnitCircle<N>::sin[i];
+        sum += x + y;
+    }
+    return sum;
+}
+
+template <bool Table>
+static float frame(int ducks, float jitter) {
+    float sum = 0.0f;
+    for (int d = 0; d < ducks; ++d) {
+        float x = 100.0f + d + jitter;
+        if (Table) {
+            sum += circleTable<20>(x, 300.0f, 19.2f) + circleTable<16>(x + 25.5f, 312.0f, 9.0f)
+                 + circleTable<12>(x + 30.0f, 315.0f, 3.0f) + circleTable<8>(x + 30.0f, 315.0f, 1.5f);
+        }
+        else {
+            sum += circleRuntime<20>(x, 300.0f, 19.2f) + circleRuntime<16>(x + 25.5f, 312.0f, 9.0f)
+                 + circleRuntime<12>(x + 30.0f, 315.0f, 3.0f) + circleRuntime<8>(x + 30.0f, 315.0f, 1.5f);
+        }
+    }
+    for (int leaf = 0; leaf < 5; ++leaf) {
+        sum += Table ? circleTable<12>(130.0f + leaf + jitter, 375.0f, 30.0f)
+                     : circleRuntime<12>(130.0f + leaf + jitter, 375.0f, 30.0f);
+    }
+    sum += Table ? circleTable<16>(400.0f + jitter, 300.0f, 5.0f) : circleRuntime<16>(400.0f + jitter, 300.0f, 5.0f);
+    return sum;
+}
+
+template <bool Table>
+static double nsPerFrame(int ducks, int frames) {
+    auto start = std::chrono::steady_clock::now();
+    for (int f = 0; f < frames; ++f) {
+        sink += frame<Table>(ducks, static_cast<float>(f & 7));
+    }
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::nano>(end - start).count() / frames;
+}
+
+int main(int argc, char** argv) {
+    int ducks = argc > 1 ? atoi(argv[1]) : 3;
+    int frames = argc > 2 ? atoi(argv[2]) : 200000;
+
+    double runtime = nsPerFrame<false>(ducks, frames);
+    double table = nsPerFrame<true>(ducks, frames);
+    int vertices = ducks * (20 + 16 + 12 + 8) + 5 * 12 + 16;
+
+    printf("circle vertices/frame: %d (%d ducks)\n", vertices, ducks);
+    printf("runtime cos/sin:       %.1f ns/frame\n", runtime);
+    printf("constexpr tables:      %.1f ns/frame\n", table);
+    printf("saved:                 %.1f ns/frame (%.1fx)\n", runtime - table, table > 0.0 ? runtime / table : 0.0);
+    return sink == 12345.0f ? 1 : 0;
+}